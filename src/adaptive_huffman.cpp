@@ -0,0 +1,180 @@
+#include "adaptive_huffman.h"
+
+AdaptiveHuffmanModel::AdaptiveHuffmanModel(const std::size_t rebuildInterval)
+{
+    always_assert(rebuildInterval > 0);
+    m_rebuildInterval = rebuildInterval;
+    m_codeLengths.resize(HUFFMAN_ADAPTIVE_ALPHABET_SIZE);
+    m_counts.fill(1);
+    m_totalCount = m_counts.size();
+    rebuild();
+}
+
+void AdaptiveHuffmanModel::rebuild()
+{
+    if (m_totalCount > HUFFMAN_ADAPTIVE_MAX_TOTAL_COUNT)
+    {
+        m_totalCount = 0;
+        for (auto &count : m_counts)
+        {
+            count = std::max<uint32_t>(1, count / 2);
+            m_totalCount += count;
+        }
+    }
+    m_builder.build(m_counts.data(), m_counts.size(), huffman::HUFFMAN_LIMITED_CODE_LENGTH, m_codeLengths.data());
+    m_symbolsUntilRebuild = m_rebuildInterval;
+}
+
+const std::vector<azgra::byte> &AdaptiveHuffmanModel::code_lengths() const
+{
+    return m_codeLengths;
+}
+
+std::size_t AdaptiveHuffmanModel::rebuild_interval() const
+{
+    return m_rebuildInterval;
+}
+
+AdaptiveHuffmanEncoder::AdaptiveHuffmanEncoder(const std::size_t rebuildInterval) : m_model(rebuildInterval)
+{
+    m_code = huffman::create_canonical_code(m_model.code_lengths());
+    m_stream.write_value(static_cast<uint32_t>(rebuildInterval));
+}
+
+void AdaptiveHuffmanEncoder::encode_symbol(const std::size_t symbol)
+{
+    const huffman::HuffmanCode &code = m_code.codes[symbol];
+    m_stream.write_bits(code.bits, code.length);
+    if (m_model.update(symbol))
+    {
+        m_code = huffman::create_canonical_code(m_model.code_lengths());
+    }
+}
+
+void AdaptiveHuffmanEncoder::encode(const azgra::StringView chunk)
+{
+    for (const char symbol : chunk)
+    {
+        encode_symbol(huffman::symbol_index(symbol));
+    }
+}
+
+azgra::ByteArray AdaptiveHuffmanEncoder::take_encoded_bytes()
+{
+    return m_stream.take_complete_bytes();
+}
+
+azgra::ByteArray AdaptiveHuffmanEncoder::finish()
+{
+    encode_symbol(HUFFMAN_ADAPTIVE_END_SYMBOL);
+    return m_stream.get_flushed_buffer();
+}
+
+std::string AdaptiveHuffmanDecoder::decode_available(const bool endOfInput)
+{
+    std::string decoded;
+    if (m_finished)
+        return decoded;
+
+    if (!m_headerRead)
+    {
+        if (m_input.size() < sizeof(uint32_t))
+            return decoded;
+
+        InWordBitStream headerStream(m_input.data(), m_input.size());
+        m_model = AdaptiveHuffmanModel(headerStream.read_value<uint32_t>());
+        m_table = huffman::create_decode_table(m_model.code_lengths());
+        m_input.erase(m_input.begin(), m_input.begin() + sizeof(uint32_t));
+        m_headerRead = true;
+    }
+
+    InWordBitStream stream(m_input.data(), m_input.size());
+    if (m_bitOffset > 0)
+    {
+        stream.read_bits(static_cast<azgra::byte>(m_bitOffset));
+    }
+
+    // NOTE(Moravec): Until the end of input, symbol is decoded only if all of its bits are available.
+    //                The rest waits for the next chunk. Rebuild can make the codes longer, so the bound
+    //                follows the current table.
+    const std::size_t availableBits = m_input.size() * 8;
+    while (stream.consumed_bits() + (endOfInput ? 1 : m_table.maxCodeLength) <= availableBits)
+    {
+        stream.refill();
+        const uint16_t symbol = huffman::decode_symbol(m_table, stream);
+        if (symbol == HUFFMAN_ADAPTIVE_END_SYMBOL)
+        {
+            m_finished = true;
+            break;
+        }
+        decoded.push_back(static_cast<char>(symbol));
+        if (m_model.update(symbol))
+        {
+            m_table = huffman::create_decode_table(m_model.code_lengths());
+        }
+    }
+
+    const std::size_t consumedBits = std::min(stream.consumed_bits(), availableBits);
+    m_input.erase(m_input.begin(), m_input.begin() + (consumedBits / 8));
+    m_bitOffset = consumedBits % 8;
+    return decoded;
+}
+
+std::string AdaptiveHuffmanDecoder::decode(const azgra::ByteArray &chunk)
+{
+    m_input.insert(m_input.end(), chunk.begin(), chunk.end());
+    return decode_available(false);
+}
+
+std::string AdaptiveHuffmanDecoder::finish()
+{
+    return decode_available(true);
+}
+
+bool AdaptiveHuffmanDecoder::finished() const
+{
+    return m_finished;
+}
+
+static void write_bytes(std::ostream &output, const azgra::ByteArray &bytes)
+{
+    output.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void huffman_encode_adaptive(std::istream &input, std::ostream &output, const std::size_t chunkSize)
+{
+    AdaptiveHuffmanEncoder encoder;
+    std::string chunk(chunkSize, '\0');
+    while (input)
+    {
+        input.read(chunk.data(), static_cast<std::streamsize>(chunkSize));
+        const auto readCount = static_cast<std::size_t>(input.gcount());
+        if (readCount == 0)
+            break;
+
+        encoder.encode(azgra::StringView(chunk.data(), readCount));
+        write_bytes(output, encoder.take_encoded_bytes());
+    }
+    write_bytes(output, encoder.finish());
+}
+
+void huffman_decode_adaptive(std::istream &input, std::ostream &output, const std::size_t chunkSize)
+{
+    AdaptiveHuffmanDecoder decoder;
+    azgra::ByteArray chunk(chunkSize);
+    while (input && !decoder.finished())
+    {
+        input.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunkSize));
+        const auto readCount = static_cast<std::size_t>(input.gcount());
+        if (readCount == 0)
+            break;
+
+        chunk.resize(readCount);
+        const std::string decoded = decoder.decode(chunk);
+        output.write(decoded.data(), static_cast<std::streamsize>(decoded.size()));
+        chunk.resize(chunkSize);
+    }
+    const std::string decoded = decoder.finish();
+    output.write(decoded.data(), static_cast<std::streamsize>(decoded.size()));
+    always_assert(decoder.finished() && "Adaptive Huffman stream is truncated.");
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "generic_huffman.h"
+#include <istream>
+#include <ostream>
+
+/**
+ * Number of coded symbols after which the adaptive code is rebuilt.
+ */
+constexpr std::size_t HUFFMAN_ADAPTIVE_REBUILD_INTERVAL = 4096;
+
+/**
+ * When the total symbol count exceeds this value, counts are halved so that the model follows local statistics.
+ */
+constexpr std::size_t HUFFMAN_ADAPTIVE_MAX_TOTAL_COUNT = 1u << 20u;
+
+/**
+ * Byte alphabet extended with the end of stream symbol.
+ */
+constexpr std::size_t HUFFMAN_ADAPTIVE_ALPHABET_SIZE = 257;
+constexpr uint16_t HUFFMAN_ADAPTIVE_END_SYMBOL = 256;
+
+/**
+ * Default size of the chunk read from the input stream.
+ */
+constexpr std::size_t HUFFMAN_ADAPTIVE_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Symbol statistics shared by the adaptive encoder and decoder. Both sides update the model with the same symbols,
+ * so the code is rebuilt at the same positions without being transmitted.
+ */
+class AdaptiveHuffmanModel
+{
+private:
+    /**
+     * Occurrence count of every symbol, starting at one so that every symbol has a code.
+     */
+    std::array<uint32_t, HUFFMAN_ADAPTIVE_ALPHABET_SIZE> m_counts{};
+
+    /**
+     * Current code lengths.
+     */
+    std::vector<azgra::byte> m_codeLengths;
+
+    /**
+     * Builder with reused scratch buffers.
+     */
+    huffman::HuffmanCodeLengthBuilder m_builder;
+
+    /**
+     * Number of symbols between rebuilds.
+     */
+    std::size_t m_rebuildInterval{HUFFMAN_ADAPTIVE_REBUILD_INTERVAL};
+
+    /**
+     * Number of symbols to code before the next rebuild.
+     */
+    std::size_t m_symbolsUntilRebuild{0};
+
+    /**
+     * Sum of all counts.
+     */
+    std::size_t m_totalCount{0};
+
+    void rebuild();
+
+public:
+    AdaptiveHuffmanModel() = default;
+
+    /**
+     * Create model with uniform statistics.
+     * @param rebuildInterval Number of symbols between rebuilds.
+     */
+    explicit AdaptiveHuffmanModel(const std::size_t rebuildInterval);
+
+    /**
+     * Update the model with the coded symbol.
+     * @param symbol Coded symbol.
+     * @return True if the code was rebuilt.
+     */
+    inline bool update(const std::size_t symbol)
+    {
+        ++m_counts[symbol];
+        ++m_totalCount;
+        if (--m_symbolsUntilRebuild == 0)
+        {
+            rebuild();
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] const std::vector<azgra::byte> &code_lengths() const;
+
+    [[nodiscard]] std::size_t rebuild_interval() const;
+};
+
+/**
+ * Single pass adaptive Huffman encoder. Input is accepted in chunks and encoded bytes can be taken incrementally.
+ */
+class AdaptiveHuffmanEncoder
+{
+private:
+    AdaptiveHuffmanModel m_model;
+
+    /**
+     * Code built from the current model.
+     */
+    huffman::CanonicalHuffmanCode m_code;
+
+    OutWordBitStream m_stream;
+
+    void encode_symbol(const std::size_t symbol);
+
+public:
+    /**
+     * Create the encoder, the rebuild interval is written to the output.
+     * @param rebuildInterval Number of symbols between rebuilds.
+     */
+    explicit AdaptiveHuffmanEncoder(const std::size_t rebuildInterval = HUFFMAN_ADAPTIVE_REBUILD_INTERVAL);
+
+    /**
+     * Encode next chunk of the input.
+     * @param chunk Input chunk.
+     */
+    void encode(const azgra::StringView chunk);
+
+    /**
+     * Take the encoded bytes produced so far.
+     * @return Encoded bytes.
+     */
+    [[nodiscard]] azgra::ByteArray take_encoded_bytes();
+
+    /**
+     * Write the end of stream symbol and take the rest of encoded bytes. Encoder can't be used afterwards.
+     * @return Encoded bytes.
+     */
+    [[nodiscard]] azgra::ByteArray finish();
+};
+
+/**
+ * Single pass adaptive Huffman decoder. Encoded bytes are accepted in chunks, only the undecoded tail is kept.
+ */
+class AdaptiveHuffmanDecoder
+{
+private:
+    AdaptiveHuffmanModel m_model;
+
+    /**
+     * Decode table built from the current model.
+     */
+    huffman::HuffmanDecodeTable m_table;
+
+    /**
+     * Encoded bytes, which were not fully decoded yet.
+     */
+    azgra::ByteArray m_input;
+
+    /**
+     * Number of already decoded bits of the first input byte.
+     */
+    std::size_t m_bitOffset{0};
+
+    bool m_headerRead{false};
+
+    bool m_finished{false};
+
+    /**
+     * Decode symbols from the buffered input.
+     * @param endOfInput True if no more input will come, the last symbol may be followed only by the padding.
+     * @return Decoded text.
+     */
+    std::string decode_available(const bool endOfInput);
+
+public:
+    AdaptiveHuffmanDecoder() = default;
+
+    /**
+     * Decode next chunk of the encoded bytes.
+     * @param chunk Encoded bytes.
+     * @return Text decoded from the available bytes.
+     */
+    std::string decode(const azgra::ByteArray &chunk);
+
+    /**
+     * Decode the rest of the buffered input, after the last chunk was passed to decode().
+     * @return Decoded text.
+     */
+    std::string finish();
+
+    /**
+     * Check whether the end of stream symbol was decoded.
+     * @return True if the whole stream was decoded.
+     */
+    [[nodiscard]] bool finished() const;
+};
+
+/**
+ * Encode input stream with the adaptive Huffman code in one pass.
+ * @param input Input stream.
+ * @param output Output stream.
+ * @param chunkSize Number of bytes read at once.
+ */
+void huffman_encode_adaptive(std::istream &input, std::ostream &output, const std::size_t chunkSize = HUFFMAN_ADAPTIVE_CHUNK_SIZE);
+
+/**
+ * Decode stream encoded by huffman_encode_adaptive.
+ * @param input Encoded input stream.
+ * @param output Output stream.
+ * @param chunkSize Number of bytes read at once.
+ */
+void huffman_decode_adaptive(std::istream &input, std::ostream &output, const std::size_t chunkSize = HUFFMAN_ADAPTIVE_CHUNK_SIZE);
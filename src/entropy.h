@@ -1,10 +1,160 @@
 #pragma once
 
 #include <map>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <azgra/always_on_assert.h>
 #include <azgra/azgra.h>
 #include <azgra/span.h>
 #include "symbol_info.h"
 
+/**
+ * Number of symbols counted into 32 bit sub-histograms before they are merged into the 64 bit histogram.
+ */
+constexpr std::size_t ENTROPY_HISTOGRAM_BATCH_SIZE = 1u << 30u;
+
+/**
+ * Check whether the histogram of the symbol type can be stored in the flat array.
+ * @tparam T Type of the symbol.
+ * @return True for 8 and 16 bit integral symbols.
+ */
+template<typename T>
+constexpr bool has_flat_histogram()
+{
+    return std::is_integral_v<T> && (sizeof(T) <= 2);
+}
+
+/**
+ * Get size of the flat histogram of the symbol type.
+ * @tparam T Type of the symbol.
+ * @return Number of distinct symbol values.
+ */
+template<typename T>
+constexpr std::size_t flat_histogram_size()
+{
+    static_assert(has_flat_histogram<T>());
+    return static_cast<std::size_t>(1) << (8 * sizeof(T));
+}
+
+/**
+ * Get number of interleaved sub-histograms. Consecutive symbols are counted into different sub-histograms,
+ * so that runs of the same symbol don't wait on the single counter.
+ * @tparam T Type of the symbol.
+ * @return Number of sub-histograms.
+ */
+template<typename T>
+constexpr std::size_t sub_histogram_count()
+{
+    return (sizeof(T) == 1) ? 4 : 2;
+}
+
+/**
+ * Add occurrence counts of the symbols to the flat histogram.
+ * @tparam T 8 or 16 bit integral type of the symbol.
+ * @param data Symbols.
+ * @param size Number of symbols.
+ * @param histogram Histogram of flat_histogram_size<T>() counts, indexed by the unsigned symbol value.
+ */
+template<typename T>
+void accumulate_histogram(const T *data, const std::size_t size, std::vector<std::size_t> &histogram)
+{
+    using UnsignedType = std::make_unsigned_t<T>;
+    constexpr std::size_t alphabetSize = flat_histogram_size<T>();
+    constexpr std::size_t subCount = sub_histogram_count<T>();
+    always_assert(histogram.size() == alphabetSize);
+
+    std::vector<uint32_t> subHistogramBuffer(subCount * alphabetSize);
+    uint32_t *subHistograms = subHistogramBuffer.data();
+    for (std::size_t batchBegin = 0; batchBegin < size; batchBegin += ENTROPY_HISTOGRAM_BATCH_SIZE)
+    {
+        const std::size_t batchEnd = std::min(size, batchBegin + ENTROPY_HISTOGRAM_BATCH_SIZE);
+        std::fill(subHistogramBuffer.begin(), subHistogramBuffer.end(), 0);
+
+        std::size_t i = batchBegin;
+        if constexpr (sizeof(T) == 1)
+        {
+            // NOTE(Moravec): Bytes are loaded by whole words, which avoids the separate load of every byte.
+            for (; i + sizeof(uint64_t) <= batchEnd; i += sizeof(uint64_t))
+            {
+                uint64_t word;
+                std::memcpy(&word, data + i, sizeof(uint64_t));
+                static_assert(subCount == 4);
+                ++subHistograms[(0 * alphabetSize) + (word & 0xFFu)];
+                ++subHistograms[(1 * alphabetSize) + ((word >> 8u) & 0xFFu)];
+                ++subHistograms[(2 * alphabetSize) + ((word >> 16u) & 0xFFu)];
+                ++subHistograms[(3 * alphabetSize) + ((word >> 24u) & 0xFFu)];
+                ++subHistograms[(0 * alphabetSize) + ((word >> 32u) & 0xFFu)];
+                ++subHistograms[(1 * alphabetSize) + ((word >> 40u) & 0xFFu)];
+                ++subHistograms[(2 * alphabetSize) + ((word >> 48u) & 0xFFu)];
+                ++subHistograms[(3 * alphabetSize) + (word >> 56u)];
+            }
+        }
+        for (; i + subCount <= batchEnd; i += subCount)
+        {
+            for (std::size_t sub = 0; sub < subCount; ++sub)
+            {
+                ++subHistograms[(sub * alphabetSize) + static_cast<UnsignedType>(data[i + sub])];
+            }
+        }
+        for (; i < batchEnd; ++i)
+        {
+            ++subHistograms[static_cast<UnsignedType>(data[i])];
+        }
+
+        // Merge is a plain loop over the flat arrays, which the compiler vectorizes.
+        for (std::size_t sub = 0; sub < subCount; ++sub)
+        {
+            const uint32_t *subHistogram = subHistograms + (sub * alphabetSize);
+            for (std::size_t symbol = 0; symbol < alphabetSize; ++symbol)
+            {
+                histogram[symbol] += subHistogram[symbol];
+            }
+        }
+    }
+}
+
+/**
+ * Count occurrences of the symbols in the flat histogram.
+ * @tparam T 8 or 16 bit integral type of the symbol.
+ * @param data Symbols.
+ * @param size Number of symbols.
+ * @return Histogram indexed by the unsigned symbol value.
+ */
+template<typename T>
+std::vector<std::size_t> get_histogram(const T *data, const std::size_t size)
+{
+    std::vector<std::size_t> histogram(flat_histogram_size<T>(), 0);
+    accumulate_histogram(data, size, histogram);
+    return histogram;
+}
+
+/**
+ * Calculate entropy from the symbol occurrence counts.
+ * @param histogram Occurrence count of every symbol.
+ * @return Entropy in bits per symbol.
+ */
+inline double calculate_entropy_from_histogram(const std::vector<std::size_t> &histogram)
+{
+    std::size_t totalCount = 0;
+    double weightedLog = 0.0;
+    for (const std::size_t count : histogram)
+    {
+        if (count == 0)
+            continue;
+        totalCount += count;
+        weightedLog += static_cast<double>(count) * std::log2(static_cast<double>(count));
+    }
+    if (totalCount == 0)
+        return 0.0;
+
+    const auto total = static_cast<double>(totalCount);
+    // H = -sum(c/N * log2(c/N)) = log2(N) - sum(c * log2(c)) / N
+    return std::max(0.0, std::log2(total) - (weightedLog / total));
+}
+
 template<typename T>
 static void find_all_symbols_in_text(std::map<T, SymbolInfo> &symbolMap, const std::vector<T> &data)
 {
@@ -53,7 +203,328 @@ double calculate_entropy(const std::map<T, SymbolInfo> &symbolMap)
 template<typename T>
 double calculate_entropy(const std::vector<T> &data)
 {
-    const auto symbolMap = get_symbols_info(data);
-    const auto entropy = calculate_entropy(symbolMap);
-    return entropy;
-}
\ No newline at end of file
+    if constexpr (has_flat_histogram<T>())
+    {
+        return calculate_entropy_from_histogram(get_histogram(data.data(), data.size()));
+    }
+    else
+    {
+        const auto symbolMap = get_symbols_info(data);
+        const auto entropy = calculate_entropy(symbolMap);
+        return entropy;
+    }
+}
+
+/**
+ * Default size of the window of the entropy profile.
+ */
+constexpr std::size_t ENTROPY_PROFILE_WINDOW_SIZE = 64 * 1024;
+
+/**
+ * Default distance between the starts of the consecutive profile windows.
+ */
+constexpr std::size_t ENTROPY_PROFILE_STRIDE = 4 * 1024;
+
+/**
+ * Entropy of the multiset of symbols, which is updated as symbols are added and removed.
+ * Sum of (count * log2(count)) is kept up to date, so the entropy is available in constant time.
+ * @tparam T 8 or 16 bit integral type of the symbol.
+ */
+template<typename T>
+class IncrementalEntropy
+{
+private:
+    using UnsignedType = std::make_unsigned_t<T>;
+
+    /**
+     * Occurrence count of every symbol.
+     */
+    std::vector<uint32_t> m_histogram;
+
+    /**
+     * Precomputed (count * log2(count)) for counts up to the maximal count.
+     */
+    std::vector<double> m_weightedLogs;
+
+    /**
+     * Number of symbols in the multiset.
+     */
+    std::size_t m_symbolCount{0};
+
+    /**
+     * Sum of (count * log2(count)) over all symbols.
+     */
+    double m_weightedLogSum{0.0};
+
+public:
+    /**
+     * Create empty multiset.
+     * @param maxSymbolCount Largest number of symbols, which will be stored at once.
+     */
+    explicit IncrementalEntropy(const std::size_t maxSymbolCount)
+    {
+        m_histogram.resize(flat_histogram_size<T>(), 0);
+        m_weightedLogs.resize(maxSymbolCount + 1, 0.0);
+        for (std::size_t count = 1; count <= maxSymbolCount; ++count)
+        {
+            m_weightedLogs[count] = static_cast<double>(count) * std::log2(static_cast<double>(count));
+        }
+    }
+
+    /**
+     * Add single occurrence of the symbol.
+     * @param symbol Symbol.
+     */
+    inline void add_symbol(const T symbol)
+    {
+        uint32_t &count = m_histogram[static_cast<UnsignedType>(symbol)];
+        m_weightedLogSum += m_weightedLogs[count + 1] - m_weightedLogs[count];
+        ++count;
+        ++m_symbolCount;
+    }
+
+    /**
+     * Remove single occurrence of the symbol, which has to be present.
+     * @param symbol Symbol.
+     */
+    inline void remove_symbol(const T symbol)
+    {
+        uint32_t &count = m_histogram[static_cast<UnsignedType>(symbol)];
+        m_weightedLogSum += m_weightedLogs[count - 1] - m_weightedLogs[count];
+        --count;
+        --m_symbolCount;
+    }
+
+    /**
+     * Remove all symbols.
+     */
+    void clear()
+    {
+        std::fill(m_histogram.begin(), m_histogram.end(), 0);
+        m_symbolCount = 0;
+        m_weightedLogSum = 0.0;
+    }
+
+    /**
+     * Get entropy of the current symbols.
+     * @return Entropy in bits per symbol.
+     */
+    [[nodiscard]] double entropy() const
+    {
+        if (m_symbolCount == 0)
+            return 0.0;
+        const auto total = static_cast<double>(m_symbolCount);
+        return std::max(0.0, std::log2(total) - (m_weightedLogSum / total));
+    }
+};
+
+/**
+ * Calculate entropy of the sliding window over the data. Histogram is updated only by the symbols, which enter
+ * and leave the window, so the cost is linear in the data size, not in (data size * window size).
+ * @tparam T 8 or 16 bit integral type of the symbol.
+ * @param data Symbols.
+ * @param size Number of symbols.
+ * @param windowSize Number of symbols in the window.
+ * @param stride Distance between the starts of the consecutive windows.
+ * @return Entropy of every window, window i starts at (i * stride). Data shorter than the window gives single value.
+ */
+template<typename T>
+std::vector<double> calculate_entropy_profile(const T *data,
+                                              const std::size_t size,
+                                              const std::size_t windowSize = ENTROPY_PROFILE_WINDOW_SIZE,
+                                              const std::size_t stride = ENTROPY_PROFILE_STRIDE)
+{
+    always_assert(windowSize > 0 && stride > 0);
+    std::vector<double> profile;
+    if (size == 0)
+        return profile;
+
+    const std::size_t firstWindowSize = std::min(windowSize, size);
+    IncrementalEntropy<T> windowEntropy(firstWindowSize);
+    for (std::size_t i = 0; i < firstWindowSize; ++i)
+    {
+        windowEntropy.add_symbol(data[i]);
+    }
+    profile.push_back(windowEntropy.entropy());
+
+    for (std::size_t windowBegin = stride; windowBegin + windowSize <= size; windowBegin += stride)
+    {
+        const std::size_t previousBegin = windowBegin - stride;
+        if (stride >= windowSize)
+        {
+            // Windows don't overlap, nothing can be reused.
+            windowEntropy.clear();
+            for (std::size_t i = windowBegin; i < windowBegin + windowSize; ++i)
+            {
+                windowEntropy.add_symbol(data[i]);
+            }
+        }
+        else
+        {
+            for (std::size_t i = previousBegin; i < windowBegin; ++i)
+            {
+                windowEntropy.remove_symbol(data[i]);
+            }
+            for (std::size_t i = previousBegin + windowSize; i < windowBegin + windowSize; ++i)
+            {
+                windowEntropy.add_symbol(data[i]);
+            }
+        }
+        profile.push_back(windowEntropy.entropy());
+    }
+    return profile;
+}
+
+/**
+ * Highest order of the context entropy estimator, context and the symbol form single 64 bit key.
+ */
+constexpr std::size_t ENTROPY_CONTEXT_MAX_ORDER = 7;
+
+/**
+ * Number of bits of the hashed (context, symbol) table.
+ */
+constexpr azgra::byte ENTROPY_CONTEXT_PAIR_HASH_BITS = 21;
+
+/**
+ * Number of bits of the hashed context table.
+ */
+constexpr azgra::byte ENTROPY_CONTEXT_HASH_BITS = 20;
+
+/**
+ * Occurrence counts of the order-k contexts and of the symbols following them, stored in hashed tables
+ * of fixed size. Colliding keys share the counter, so the conditional entropy is an estimate, which is exact
+ * as long as the number of distinct keys is small compared to the table size.
+ */
+class ContextHistogram
+{
+private:
+    /**
+     * Number of bytes of the context.
+     */
+    std::size_t m_order{0};
+
+    /**
+     * Mask of the rolling context.
+     */
+    uint64_t m_contextMask{0};
+
+    /**
+     * Hashed occurrence count of every context.
+     */
+    std::vector<uint64_t> m_contextCounts;
+
+    /**
+     * Hashed occurrence count of every (context, symbol) pair.
+     */
+    std::vector<uint64_t> m_pairCounts;
+
+    /**
+     * Number of counted symbols.
+     */
+    std::size_t m_symbolCount{0};
+
+    static inline std::size_t hash_key(const uint64_t key, const azgra::byte bits)
+    {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> (64u - bits));
+    }
+
+public:
+    /**
+     * Create empty histogram.
+     * @param order Number of bytes of the context, at most ENTROPY_CONTEXT_MAX_ORDER.
+     */
+    explicit ContextHistogram(const std::size_t order) : m_order(order)
+    {
+        always_assert(order <= ENTROPY_CONTEXT_MAX_ORDER);
+        m_contextMask = (order == 0) ? 0 : ((static_cast<uint64_t>(1) << (8 * order)) - 1);
+        m_contextCounts.resize(static_cast<std::size_t>(1) << ENTROPY_CONTEXT_HASH_BITS, 0);
+        m_pairCounts.resize(static_cast<std::size_t>(1) << ENTROPY_CONTEXT_PAIR_HASH_BITS, 0);
+    }
+
+    /**
+     * Count bytes of the data in their contexts. Context of the first bytes is padded with zeros.
+     * @param data Bytes, the first prefixSize bytes only form the context of the following ones.
+     * @param size Number of bytes.
+     * @param prefixSize Number of bytes preceding the counted part.
+     */
+    void accumulate(const azgra::byte *data, const std::size_t size, const std::size_t prefixSize = 0)
+    {
+        uint64_t context = 0;
+        for (std::size_t i = 0; i < prefixSize; ++i)
+        {
+            context = ((context << 8u) | data[i]) & m_contextMask;
+        }
+        for (std::size_t i = prefixSize; i < size; ++i)
+        {
+            ++m_contextCounts[hash_key(context, ENTROPY_CONTEXT_HASH_BITS)];
+            ++m_pairCounts[hash_key((context << 8u) | data[i], ENTROPY_CONTEXT_PAIR_HASH_BITS)];
+            context = ((context << 8u) | data[i]) & m_contextMask;
+        }
+        m_symbolCount += size - prefixSize;
+    }
+
+    /**
+     * Add counts of the other histogram of the same order.
+     * @param other Other histogram.
+     */
+    void merge(const ContextHistogram &other)
+    {
+        always_assert(m_order == other.m_order);
+        for (std::size_t i = 0; i < m_contextCounts.size(); ++i)
+        {
+            m_contextCounts[i] += other.m_contextCounts[i];
+        }
+        for (std::size_t i = 0; i < m_pairCounts.size(); ++i)
+        {
+            m_pairCounts[i] += other.m_pairCounts[i];
+        }
+        m_symbolCount += other.m_symbolCount;
+    }
+
+    /**
+     * Get conditional entropy of the symbol given its context.
+     * H = (sum(n(c) * log2(n(c))) - sum(n(c,x) * log2(n(c,x)))) / N
+     * @return Entropy in bits per symbol.
+     */
+    [[nodiscard]] double entropy() const
+    {
+        if (m_symbolCount == 0)
+            return 0.0;
+        const auto weighted_log_sum = [](const std::vector<uint64_t> &counts)
+        {
+            double sum = 0.0;
+            for (const uint64_t count : counts)
+            {
+                if (count > 1)
+                    sum += static_cast<double>(count) * std::log2(static_cast<double>(count));
+            }
+            return sum;
+        };
+        const double entropy = (weighted_log_sum(m_contextCounts) - weighted_log_sum(m_pairCounts)) /
+                               static_cast<double>(m_symbolCount);
+        return std::max(0.0, entropy);
+    }
+
+    /**
+     * Get number of counted symbols.
+     * @return Number of symbols.
+     */
+    [[nodiscard]] std::size_t symbol_count() const
+    {
+        return m_symbolCount;
+    }
+};
+
+/**
+ * Estimate order-k conditional entropy of the data.
+ * @param data Bytes.
+ * @param size Number of bytes.
+ * @param order Number of bytes of the context.
+ * @return Entropy in bits per byte.
+ */
+inline double calculate_context_entropy(const azgra::byte *data, const std::size_t size, const std::size_t order)
+{
+    ContextHistogram histogram(order);
+    histogram.accumulate(data, size);
+    return histogram.entropy();
+}
@@ -0,0 +1,100 @@
+#include "file_entropy.h"
+
+std::size_t get_file_size(const char *inputFile)
+{
+    std::ifstream input(inputFile, std::ios::binary | std::ios::ate);
+    always_assert(input.is_open() && "Failed to open the input file.");
+    return static_cast<std::size_t>(input.tellg());
+}
+
+std::vector<std::size_t> get_file_histogram(const char *inputFile, const std::size_t chunkSize)
+{
+    const std::vector<std::size_t> emptyHistogram(flat_histogram_size<azgra::byte>(), 0);
+    return process_file_chunks(inputFile, chunkSize, 0, emptyHistogram,
+                               [](std::vector<std::size_t> &histogram, const azgra::byte *data,
+                                  const std::size_t dataSize, const std::size_t, const std::size_t)
+                               {
+                                   accumulate_histogram(data, dataSize, histogram);
+                               },
+                               [](std::vector<std::size_t> &result, const std::vector<std::size_t> &histogram)
+                               {
+                                   for (std::size_t symbol = 0; symbol < result.size(); ++symbol)
+                                   {
+                                       result[symbol] += histogram[symbol];
+                                   }
+                               });
+}
+
+double calculate_file_entropy(const char *inputFile, const std::size_t chunkSize)
+{
+    return calculate_entropy_from_histogram(get_file_histogram(inputFile, chunkSize));
+}
+
+std::vector<double> calculate_file_entropy_profile(const char *inputFile,
+                                                   const std::size_t windowSize,
+                                                   const std::size_t stride,
+                                                   const std::size_t chunkSize)
+{
+    always_assert(windowSize > 0 && stride > 0);
+    const std::size_t fileSize = get_file_size(inputFile);
+    if (fileSize < windowSize)
+    {
+        const auto histogram = get_file_histogram(inputFile, chunkSize);
+        return (fileSize > 0) ? std::vector<double>{calculate_entropy_from_histogram(histogram)} : std::vector<double>();
+    }
+
+    using WindowEntropies = std::vector<std::pair<std::size_t, double>>;
+    WindowEntropies windowEntropies = process_file_chunks(
+            inputFile, chunkSize, windowSize, WindowEntropies(),
+            [windowSize, stride](WindowEntropies &entropies, const azgra::byte *data, const std::size_t dataSize,
+                                 const std::size_t prefixSize, const std::size_t chunkOffset)
+            {
+                // NOTE(Moravec): Chunk computes the windows, which end inside of it. Window k spans
+                //                [k * stride, k * stride + windowSize), its start lies in the chunk prefix at worst.
+                const std::size_t chunkEnd = chunkOffset + dataSize - prefixSize;
+                if (chunkEnd < windowSize)
+                    return;
+                const std::size_t firstWindow = (chunkOffset < windowSize) ? 0 : ((chunkOffset - windowSize) / stride) + 1;
+                const std::size_t lastWindow = (chunkEnd - windowSize) / stride;
+                if (firstWindow > lastWindow)
+                    return;
+
+                const std::size_t dataBegin = chunkOffset - prefixSize;
+                const std::size_t firstWindowBegin = firstWindow * stride;
+                const std::size_t profileSize = (lastWindow * stride) + windowSize - firstWindowBegin;
+                const auto chunkProfile = calculate_entropy_profile(data + (firstWindowBegin - dataBegin), profileSize,
+                                                                    windowSize, stride);
+                for (std::size_t i = 0; i < chunkProfile.size(); ++i)
+                {
+                    entropies.emplace_back(firstWindow + i, chunkProfile[i]);
+                }
+            },
+            [](WindowEntropies &result, const WindowEntropies &entropies)
+            {
+                result.insert(result.end(), entropies.begin(), entropies.end());
+            });
+    std::sort(windowEntropies.begin(), windowEntropies.end());
+
+    std::vector<double> profile(windowEntropies.size());
+    for (std::size_t i = 0; i < windowEntropies.size(); ++i)
+    {
+        profile[i] = windowEntropies[i].second;
+    }
+    return profile;
+}
+
+double calculate_file_context_entropy(const char *inputFile, const std::size_t order, const std::size_t chunkSize)
+{
+    const ContextHistogram histogram = process_file_chunks(
+            inputFile, chunkSize, order, ContextHistogram(order),
+            [](ContextHistogram &threadHistogram, const azgra::byte *data, const std::size_t dataSize,
+               const std::size_t prefixSize, const std::size_t)
+            {
+                threadHistogram.accumulate(data, dataSize, prefixSize);
+            },
+            [](ContextHistogram &result, const ContextHistogram &threadHistogram)
+            {
+                result.merge(threadHistogram);
+            });
+    return histogram.entropy();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <fstream>
+#include "entropy.h"
+
+/**
+ * Default size of the file chunk processed by single thread.
+ */
+constexpr std::size_t ENTROPY_FILE_CHUNK_SIZE = 16 * 1024 * 1024;
+
+/**
+ * Get size of the file in bytes.
+ * @param inputFile Input file.
+ * @return Size of the file.
+ */
+std::size_t get_file_size(const char *inputFile);
+
+/**
+ * Process the file in chunks in parallel. Every thread reads its chunks into own buffer and updates own state,
+ * so the peak memory is (threads * (chunkSize + prefixSize)) regardless of the file size.
+ * @tparam State Type of the thread state.
+ * @tparam ChunkFunction Function (State &, const azgra::byte *data, size_t dataSize, size_t prefixSize, size_t chunkOffset).
+ * @tparam MergeFunction Function (State &result, const State &threadState).
+ * @param inputFile Input file.
+ * @param chunkSize Number of bytes of the chunk.
+ * @param prefixSize Number of bytes preceding the chunk, which are read in front of it. Used as the context.
+ * @param initialState Initial state of every thread and of the result.
+ * @param processChunk Chunk function, the first prefixSize bytes (fewer at the file start) precede the chunk,
+ *                     chunkOffset is the file offset of the first chunk byte.
+ * @param mergeStates Merge function, called once per thread.
+ * @return Merged state.
+ */
+template<typename State, typename ChunkFunction, typename MergeFunction>
+State process_file_chunks(const char *inputFile,
+                          const std::size_t chunkSize,
+                          const std::size_t prefixSize,
+                          const State &initialState,
+                          ChunkFunction &&processChunk,
+                          MergeFunction &&mergeStates)
+{
+    always_assert(chunkSize > 0);
+    const std::size_t fileSize = get_file_size(inputFile);
+    const auto chunkCount = static_cast<long>((fileSize + chunkSize - 1) / chunkSize);
+
+    State result = initialState;
+    bool readFailed = false;
+#pragma omp parallel default(none) shared(result, initialState, processChunk, mergeStates, inputFile) firstprivate(chunkCount, chunkSize, prefixSize, fileSize) reduction(||:readFailed)
+    {
+        State threadState = initialState;
+        std::ifstream input(inputFile, std::ios::binary);
+        std::vector<azgra::byte> buffer(prefixSize + chunkSize);
+
+#pragma omp for schedule(dynamic)
+        for (long chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            const std::size_t chunkBegin = chunk * chunkSize;
+            const std::size_t chunkPrefixSize = std::min(prefixSize, chunkBegin);
+            const std::size_t readSize = chunkPrefixSize + std::min(chunkSize, fileSize - chunkBegin);
+
+            input.seekg(static_cast<std::streamoff>(chunkBegin - chunkPrefixSize));
+            input.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(readSize));
+            if (static_cast<std::size_t>(input.gcount()) != readSize)
+            {
+                readFailed = true;
+                input.clear();
+                continue;
+            }
+            processChunk(threadState, buffer.data(), readSize, chunkPrefixSize, chunkBegin);
+        }
+
+#pragma omp critical
+        {
+            mergeStates(result, threadState);
+        }
+    }
+    always_assert(!readFailed && "Failed to read the input file.");
+    return result;
+}
+
+/**
+ * Get byte histogram of the file, which is read in chunks by multiple threads.
+ * @param inputFile Input file.
+ * @param chunkSize Number of bytes of the chunk.
+ * @return Occurrence count of every byte.
+ */
+std::vector<std::size_t> get_file_histogram(const char *inputFile, const std::size_t chunkSize = ENTROPY_FILE_CHUNK_SIZE);
+
+/**
+ * Calculate order-0 entropy of the file without loading the whole file into memory.
+ * @param inputFile Input file.
+ * @param chunkSize Number of bytes of the chunk.
+ * @return Entropy in bits per byte.
+ */
+double calculate_file_entropy(const char *inputFile, const std::size_t chunkSize = ENTROPY_FILE_CHUNK_SIZE);
+
+/**
+ * Calculate entropy profile of the file. Chunks are processed in parallel, every chunk reads the window
+ * in front of it, so that the windows crossing the chunk boundary are computed too.
+ * @param inputFile Input file.
+ * @param windowSize Number of bytes in the window.
+ * @param stride Distance between the starts of the consecutive windows.
+ * @param chunkSize Number of bytes of the chunk.
+ * @return Entropy of every window, window i starts at (i * stride). File shorter than the window gives single value.
+ */
+std::vector<double> calculate_file_entropy_profile(const char *inputFile,
+                                                   const std::size_t windowSize = ENTROPY_PROFILE_WINDOW_SIZE,
+                                                   const std::size_t stride = ENTROPY_PROFILE_STRIDE,
+                                                   const std::size_t chunkSize = ENTROPY_FILE_CHUNK_SIZE);
+
+/**
+ * Estimate order-k conditional entropy of the file. Chunks are processed in parallel, every chunk reads
+ * order bytes in front of it as the context of its first bytes.
+ * @param inputFile Input file.
+ * @param order Number of bytes of the context, at most ENTROPY_CONTEXT_MAX_ORDER.
+ * @param chunkSize Number of bytes of the chunk.
+ * @return Entropy in bits per byte.
+ */
+double calculate_file_context_entropy(const char *inputFile,
+                                      const std::size_t order,
+                                      const std::size_t chunkSize = ENTROPY_FILE_CHUNK_SIZE);
@@ -5,7 +5,11 @@
 #include <vector>
 #include <queue>
 #include <map>
+#include <array>
+#include <algorithm>
+#include <type_traits>
 #include <azgra/collection/enumerable_functions.h>
+#include "word_bit_stream.h"
 
 namespace huffman
 {
@@ -174,4 +178,676 @@ namespace huffman
         return result;
     }
 
+    /**
+     * Number of bits resolved by the first level of the decode table.
+     */
+    constexpr azgra::byte HUFFMAN_DECODE_TABLE_BITS = 11;
+
+    /**
+     * Longest code length supported by the canonical coder.
+     */
+    constexpr azgra::byte HUFFMAN_MAX_CODE_LENGTH = 32;
+
+    /**
+     * Default code length limit, so that every code fits into the decode table with single fallback step.
+     */
+    constexpr azgra::byte HUFFMAN_LIMITED_CODE_LENGTH = 15;
+
+    /**
+     * Longest code length, for which the second level decode tables are built. Longer codes are decoded by search.
+     */
+    constexpr azgra::byte HUFFMAN_MAX_TWO_LEVEL_CODE_LENGTH = 24;
+
+    /**
+     * Get index of the symbol in the dense alphabet.
+     * @tparam SymbolType Type of the symbol.
+     * @param symbol Symbol.
+     * @return Unsigned index of the symbol.
+     */
+    template<typename SymbolType>
+    constexpr std::size_t symbol_index(const SymbolType symbol)
+    {
+        static_assert(std::is_integral_v<SymbolType>);
+        return static_cast<std::make_unsigned_t<SymbolType>>(symbol);
+    }
+
+    /**
+     * Huffman code stored as integer. Bits are emitted from the most significant one.
+     */
+    struct HuffmanCode
+    {
+        uint32_t bits{0};
+        azgra::byte length{0};
+    };
+
+    /**
+     * Canonical Huffman code, derived only from code lengths.
+     */
+    struct CanonicalHuffmanCode
+    {
+        /**
+         * Code length of every symbol of the alphabet, zero for unused symbols.
+         */
+        std::vector<azgra::byte> codeLengths;
+
+        /**
+         * Code of every symbol of the alphabet.
+         */
+        std::vector<HuffmanCode> codes;
+
+        /**
+         * Length of the longest code.
+         */
+        azgra::byte maxCodeLength{0};
+    };
+
+    /**
+     * Entry of the first or second level decode table.
+     */
+    struct HuffmanDecodeEntry
+    {
+        /**
+         * Decoded symbol, or index of the second level table if the code is longer than the table bits.
+         */
+        uint16_t symbol{0};
+        /**
+         * Code length, zero if the code is longer than the table bits.
+         */
+        azgra::byte length{0};
+        /**
+         * Number of bits indexing the second level table, zero if there is no second level table.
+         */
+        azgra::byte subTableBits{0};
+    };
+
+    /**
+     * Table driven decoder of the canonical Huffman code.
+     */
+    struct HuffmanDecodeTable
+    {
+        /**
+         * Number of bits used to index entries.
+         */
+        azgra::byte tableBits{0};
+
+        /**
+         * Length of the longest code.
+         */
+        azgra::byte maxCodeLength{0};
+
+        /**
+         * Entries indexed by the next tableBits bits.
+         */
+        std::vector<HuffmanDecodeEntry> entries;
+
+        /**
+         * Second level tables for codes longer than tableBits, indexed by the bits following the first level prefix.
+         */
+        std::vector<HuffmanDecodeEntry> subEntries;
+
+        /**
+         * Offset of every second level table in subEntries.
+         */
+        std::vector<uint32_t> subTableOffsets;
+
+        /**
+         * First canonical code of every length, used for long codes.
+         */
+        std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> firstCode{};
+
+        /**
+         * Number of codes of every length.
+         */
+        std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> lengthCount{};
+
+        /**
+         * Index into sortedSymbols of the first symbol of every length.
+         */
+        std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> firstSymbolIndex{};
+
+        /**
+         * Symbols in the canonical order.
+         */
+        std::vector<uint16_t> sortedSymbols;
+    };
+
+    /**
+     * Assign canonical codes to symbols. Shorter codes come first, ties are ordered by the symbol.
+     * @param codeLengths Code length of every symbol.
+     * @return Canonical code.
+     */
+    inline CanonicalHuffmanCode create_canonical_code(const std::vector<azgra::byte> &codeLengths)
+    {
+        CanonicalHuffmanCode result = {};
+        result.codeLengths = codeLengths;
+        result.codes.resize(codeLengths.size());
+
+        std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> lengthCount{};
+        for (const azgra::byte length : codeLengths)
+        {
+            always_assert(length <= HUFFMAN_MAX_CODE_LENGTH);
+            ++lengthCount[length];
+            result.maxCodeLength = std::max(result.maxCodeLength, length);
+        }
+        lengthCount[0] = 0;
+
+        std::array<uint64_t, HUFFMAN_MAX_CODE_LENGTH + 1> nextCode{};
+        uint64_t code = 0;
+        for (std::size_t length = 1; length <= HUFFMAN_MAX_CODE_LENGTH; ++length)
+        {
+            code = (code + lengthCount[length - 1]) << 1u;
+            nextCode[length] = code;
+        }
+
+        for (std::size_t symbol = 0; symbol < codeLengths.size(); ++symbol)
+        {
+            const azgra::byte length = codeLengths[symbol];
+            if (length == 0)
+                continue;
+            result.codes[symbol].bits = static_cast<uint32_t>(nextCode[length]++);
+            result.codes[symbol].length = length;
+        }
+        return result;
+    }
+
+    /**
+     * Create second level tables for the first level prefixes of long codes. Every table is sized by the longest
+     * code with its prefix.
+     * @param table Decode table with the filled first level.
+     * @param canonicalCode Canonical code.
+     */
+    inline void create_sub_tables(HuffmanDecodeTable &table, const CanonicalHuffmanCode &canonicalCode)
+    {
+        const azgra::byte tableBits = table.tableBits;
+        for (std::size_t symbol = 0; symbol < canonicalCode.codes.size(); ++symbol)
+        {
+            const HuffmanCode &code = canonicalCode.codes[symbol];
+            if (code.length <= tableBits)
+                continue;
+            HuffmanDecodeEntry &link = table.entries[code.bits >> static_cast<azgra::byte>(code.length - tableBits)];
+            link.subTableBits = std::max(link.subTableBits, static_cast<azgra::byte>(code.length - tableBits));
+        }
+
+        uint32_t subEntryCount = 0;
+        for (HuffmanDecodeEntry &link : table.entries)
+        {
+            if (link.subTableBits == 0)
+                continue;
+            link.symbol = static_cast<uint16_t>(table.subTableOffsets.size());
+            table.subTableOffsets.push_back(subEntryCount);
+            subEntryCount += 1u << link.subTableBits;
+        }
+        table.subEntries.resize(subEntryCount);
+
+        for (std::size_t symbol = 0; symbol < canonicalCode.codes.size(); ++symbol)
+        {
+            const HuffmanCode &code = canonicalCode.codes[symbol];
+            if (code.length <= tableBits)
+                continue;
+            const auto suffixBits = static_cast<azgra::byte>(code.length - tableBits);
+            const HuffmanDecodeEntry &link = table.entries[code.bits >> suffixBits];
+            const auto shift = static_cast<azgra::byte>(link.subTableBits - suffixBits);
+            const uint32_t first = table.subTableOffsets[link.symbol] + ((code.bits & ((1u << suffixBits) - 1)) << shift);
+            const uint32_t count = 1u << shift;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                table.subEntries[first + i].symbol = static_cast<uint16_t>(symbol);
+                table.subEntries[first + i].length = code.length;
+            }
+        }
+    }
+
+    /**
+     * Create decode table of the canonical code.
+     * @param codeLengths Code length of every symbol.
+     * @param tableBits Maximum number of bits resolved by a single table lookup.
+     * @return Decode table.
+     */
+    inline HuffmanDecodeTable create_decode_table(const std::vector<azgra::byte> &codeLengths,
+                                                  const azgra::byte tableBits = HUFFMAN_DECODE_TABLE_BITS)
+    {
+        always_assert(codeLengths.size() <= (1u << 16u));
+        // NOTE(Moravec): Over-subscribed code lengths (Kraft sum above one) would fill the tables past their end.
+        uint64_t kraftSum = 0;
+        for (const azgra::byte length : codeLengths)
+        {
+            always_assert(length <= HUFFMAN_MAX_CODE_LENGTH && "Invalid Huffman code length.");
+            if (length > 0)
+                kraftSum += 1ull << static_cast<azgra::byte>(HUFFMAN_MAX_CODE_LENGTH - length);
+        }
+        always_assert(kraftSum <= (1ull << HUFFMAN_MAX_CODE_LENGTH) && "Over-subscribed Huffman code lengths.");
+        const CanonicalHuffmanCode canonicalCode = create_canonical_code(codeLengths);
+
+        HuffmanDecodeTable table = {};
+        table.maxCodeLength = canonicalCode.maxCodeLength;
+        table.tableBits = std::max<azgra::byte>(1, std::min(tableBits, canonicalCode.maxCodeLength));
+        table.entries.resize(1u << table.tableBits);
+
+        for (const azgra::byte length : codeLengths)
+        {
+            if (length > 0)
+                ++table.lengthCount[length];
+        }
+        uint32_t code = 0;
+        uint32_t symbolIndex = 0;
+        for (std::size_t length = 1; length <= HUFFMAN_MAX_CODE_LENGTH; ++length)
+        {
+            table.firstCode[length] = code;
+            table.firstSymbolIndex[length] = symbolIndex;
+            code = (code + table.lengthCount[length]) << 1u;
+            symbolIndex += table.lengthCount[length];
+        }
+
+        table.sortedSymbols.resize(symbolIndex);
+        std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> nextIndex = table.firstSymbolIndex;
+        for (std::size_t symbol = 0; symbol < codeLengths.size(); ++symbol)
+        {
+            const azgra::byte length = codeLengths[symbol];
+            if (length == 0)
+                continue;
+            table.sortedSymbols[nextIndex[length]++] = static_cast<uint16_t>(symbol);
+
+            if (length <= table.tableBits)
+            {
+                // Every index with this code as prefix resolves to the symbol.
+                const auto shift = static_cast<azgra::byte>(table.tableBits - length);
+                const uint32_t first = canonicalCode.codes[symbol].bits << shift;
+                const uint32_t count = 1u << shift;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    table.entries[first + i].symbol = static_cast<uint16_t>(symbol);
+                    table.entries[first + i].length = length;
+                }
+            }
+        }
+
+        if ((table.maxCodeLength > table.tableBits) && (table.maxCodeLength <= HUFFMAN_MAX_TWO_LEVEL_CODE_LENGTH))
+        {
+            create_sub_tables(table, canonicalCode);
+        }
+        return table;
+    }
+
+    /**
+     * Decode symbol which didn't fit into the first level of the decode table.
+     * @param table Decode table.
+     * @param stream Refilled bit stream.
+     * @return Decoded symbol.
+     */
+    inline uint16_t decode_long_symbol(const HuffmanDecodeTable &table, InWordBitStream &stream)
+    {
+        for (azgra::byte length = table.tableBits + 1; length <= table.maxCodeLength; ++length)
+        {
+            const uint32_t offset = stream.peek_bits(length) - table.firstCode[length];
+            if (offset < table.lengthCount[length])
+            {
+                stream.consume_bits(length);
+                return table.sortedSymbols[table.firstSymbolIndex[length] + offset];
+            }
+        }
+        always_assert(false && "Invalid canonical Huffman code.");
+        return 0;
+    }
+
+    /**
+     * Get number of symbols which can be decoded after single refill of the bit stream.
+     * @param table Decode table.
+     * @return Number of symbols per refill.
+     */
+    inline std::size_t symbols_per_refill(const HuffmanDecodeTable &table)
+    {
+        return std::max<std::size_t>(1, 56 / std::max<azgra::byte>(1, table.maxCodeLength));
+    }
+
+    /**
+     * Decode single symbol from the stream. Caller is responsible for the stream refill.
+     * @param table Decode table.
+     * @param stream Bit stream.
+     * @return Decoded symbol.
+     */
+    inline uint16_t decode_symbol(const HuffmanDecodeTable &table, InWordBitStream &stream)
+    {
+        const HuffmanDecodeEntry &entry = table.entries[stream.peek_bits(table.tableBits)];
+        if (entry.length > 0)
+        {
+            stream.consume_bits(entry.length);
+            return entry.symbol;
+        }
+        if (entry.subTableBits > 0)
+        {
+            const uint32_t subIndex = stream.peek_bits(table.tableBits + entry.subTableBits) & ((1u << entry.subTableBits) - 1);
+            const HuffmanDecodeEntry &subEntry = table.subEntries[table.subTableOffsets[entry.symbol] + subIndex];
+            stream.consume_bits(subEntry.length);
+            return subEntry.symbol;
+        }
+        return decode_long_symbol(table, stream);
+    }
+
+    /**
+     * Builder of the length-limited Huffman code lengths working on flat index arrays.
+     * Scratch buffers are kept between calls, so repeated builds of the per-block codes don't allocate.
+     */
+    class HuffmanCodeLengthBuilder
+    {
+    private:
+        /**
+         * Used symbols sorted by their occurrence count.
+         */
+        std::vector<uint32_t> m_symbols;
+
+        /**
+         * Weights of leaves followed by weights of merged nodes. Reused for node depths.
+         */
+        std::vector<uint64_t> m_weights;
+
+        /**
+         * Parent node of every node.
+         */
+        std::vector<uint32_t> m_parents;
+
+        /**
+         * Limit the code lengths, so that the code stays complete. Overflowing codes were already counted
+         * to the maxCodeLength, here we move codes from shorter lengths down until Kraft inequality holds.
+         * @param lengthCount Number of codes of every length.
+         * @param maxCodeLength Code length limit.
+         */
+        static void enforce_max_code_length(std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> &lengthCount,
+                                            const azgra::byte maxCodeLength)
+        {
+            uint64_t kraftTotal = 0;
+            for (azgra::byte length = 1; length <= maxCodeLength; ++length)
+            {
+                kraftTotal += static_cast<uint64_t>(lengthCount[length]) << static_cast<azgra::byte>(maxCodeLength - length);
+            }
+
+            const uint64_t completeTotal = 1ull << maxCodeLength;
+            while (kraftTotal > completeTotal)
+            {
+                // Take one leaf from the maximum length and split the deepest shorter leaf to make room for it.
+                --lengthCount[maxCodeLength];
+                for (azgra::byte length = maxCodeLength - 1; length > 0; --length)
+                {
+                    if (lengthCount[length] > 0)
+                    {
+                        --lengthCount[length];
+                        lengthCount[length + 1] += 2;
+                        break;
+                    }
+                }
+                --kraftTotal;
+            }
+        }
+
+    public:
+        HuffmanCodeLengthBuilder() = default;
+
+        /**
+         * Build code lengths from the symbol histogram.
+         * @param histogram Occurrence count of every symbol of the alphabet.
+         * @param alphabetSize Size of the alphabet.
+         * @param maxCodeLength Code length limit.
+         * @param codeLengths Output code length of every symbol, zero for unused symbols.
+         */
+        template<typename CountType>
+        void build(const CountType *histogram,
+                   const std::size_t alphabetSize,
+                   const azgra::byte maxCodeLength,
+                   azgra::byte *codeLengths)
+        {
+            always_assert(maxCodeLength > 0 && maxCodeLength <= HUFFMAN_MAX_CODE_LENGTH);
+            std::fill(codeLengths, codeLengths + alphabetSize, 0);
+
+            m_symbols.clear();
+            for (std::size_t symbol = 0; symbol < alphabetSize; ++symbol)
+            {
+                if (histogram[symbol] > 0)
+                    m_symbols.push_back(static_cast<uint32_t>(symbol));
+            }
+
+            const std::size_t leafCount = m_symbols.size();
+            if (leafCount == 0)
+                return;
+            if (leafCount == 1)
+            {
+                codeLengths[m_symbols[0]] = 1;
+                return;
+            }
+            always_assert((1ull << maxCodeLength) >= leafCount && "Code length limit is too small for the alphabet.");
+
+            std::sort(m_symbols.begin(), m_symbols.end(), [histogram](const uint32_t a, const uint32_t b)
+            {
+                return (histogram[a] < histogram[b]) || ((histogram[a] == histogram[b]) && (a < b));
+            });
+
+            const std::size_t nodeCount = (2 * leafCount) - 1;
+            m_weights.resize(nodeCount);
+            m_parents.resize(nodeCount);
+            for (std::size_t leaf = 0; leaf < leafCount; ++leaf)
+            {
+                m_weights[leaf] = histogram[m_symbols[leaf]];
+            }
+
+            // Two-queue merge. Sorted leaves are the first queue, merged nodes are created in non-decreasing
+            // weight order and form the second queue.
+            std::size_t leafIndex = 0;
+            std::size_t mergedIndex = leafCount;
+            const auto take_lightest = [&](const std::size_t nextNode) -> std::size_t
+            {
+                if ((leafIndex < leafCount) && ((mergedIndex >= nextNode) || (m_weights[leafIndex] <= m_weights[mergedIndex])))
+                {
+                    return leafIndex++;
+                }
+                return mergedIndex++;
+            };
+            for (std::size_t node = leafCount; node < nodeCount; ++node)
+            {
+                const std::size_t a = take_lightest(node);
+                const std::size_t b = take_lightest(node);
+                m_weights[node] = m_weights[a] + m_weights[b];
+                m_parents[a] = static_cast<uint32_t>(node);
+                m_parents[b] = static_cast<uint32_t>(node);
+            }
+
+            // Parents always follow their children, so depths can be computed from the root in place.
+            std::array<uint32_t, HUFFMAN_MAX_CODE_LENGTH + 1> lengthCount{};
+            bool overflow = false;
+            m_weights[nodeCount - 1] = 0;
+            for (long node = static_cast<long>(nodeCount) - 2; node >= 0; --node)
+            {
+                const uint64_t depth = m_weights[m_parents[node]] + 1;
+                m_weights[node] = depth;
+                if (node < static_cast<long>(leafCount))
+                {
+                    overflow |= (depth > maxCodeLength);
+                    ++lengthCount[std::min<uint64_t>(depth, maxCodeLength)];
+                }
+            }
+
+            if (overflow)
+            {
+                enforce_max_code_length(lengthCount, maxCodeLength);
+            }
+
+            // Least frequent symbols get the longest codes.
+            std::size_t symbolIndex = 0;
+            for (azgra::byte length = maxCodeLength; length > 0; --length)
+            {
+                for (uint32_t i = 0; i < lengthCount[length]; ++i)
+                {
+                    codeLengths[m_symbols[symbolIndex++]] = length;
+                }
+            }
+        }
+    };
+
+    /**
+     * Build length-limited code lengths from the symbol histogram.
+     * @param histogram Occurrence count of every symbol of the alphabet.
+     * @param maxCodeLength Code length limit.
+     * @return Code length of every symbol.
+     */
+    template<typename CountType>
+    std::vector<azgra::byte> build_code_lengths(const std::vector<CountType> &histogram,
+                                                const azgra::byte maxCodeLength = HUFFMAN_LIMITED_CODE_LENGTH)
+    {
+        std::vector<azgra::byte> codeLengths(histogram.size());
+        HuffmanCodeLengthBuilder().build(histogram.data(), histogram.size(), maxCodeLength, codeLengths.data());
+        return codeLengths;
+    }
+
+    /**
+     * Number of bits of the single code length in the compact header of the byte alphabet.
+     */
+    constexpr azgra::byte HUFFMAN_HEADER_NIBBLE_BITS = 4;
+
+    namespace
+    {
+        /**
+         * Get number of tokens of the run length. Every token carries (tokenBits - 1) bits of the value
+         * and the continuation bit.
+         * @param value Run length value.
+         * @param tokenBits Number of bits of the token.
+         * @return Number of tokens.
+         */
+        inline std::size_t token_varint_size(std::size_t value, const azgra::byte tokenBits)
+        {
+            std::size_t tokenCount = 1;
+            while (value >>= static_cast<azgra::byte>(tokenBits - 1))
+            {
+                ++tokenCount;
+            }
+            return tokenCount;
+        }
+
+        inline void write_token_varint(OutWordBitStream &stream, std::size_t value, const azgra::byte tokenBits)
+        {
+            const auto valueBits = static_cast<azgra::byte>(tokenBits - 1);
+            const uint32_t continuationBit = 1u << valueBits;
+            do
+            {
+                uint32_t token = value & (continuationBit - 1);
+                value >>= valueBits;
+                if (value > 0)
+                    token |= continuationBit;
+                stream.write_bits(token, tokenBits);
+            } while (value > 0);
+        }
+
+        inline std::size_t read_token_varint(InWordBitStream &stream, const azgra::byte tokenBits)
+        {
+            const auto valueBits = static_cast<azgra::byte>(tokenBits - 1);
+            const uint32_t continuationBit = 1u << valueBits;
+            std::size_t value = 0;
+            std::size_t shift = 0;
+            uint32_t token;
+            do
+            {
+                always_assert(shift < 64 && "Corrupted code lengths header.");
+                token = stream.read_bits(tokenBits);
+                value |= static_cast<std::size_t>(token & (continuationBit - 1)) << shift;
+                shift += valueBits;
+            } while (token & continuationBit);
+            return value;
+        }
+
+        /**
+         * Get length of the run of unused symbols.
+         * @param codeLengths Code lengths.
+         * @param symbol First unused symbol.
+         * @return Number of consecutive unused symbols.
+         */
+        inline std::size_t unused_run_length(const std::vector<azgra::byte> &codeLengths, const std::size_t symbol)
+        {
+            std::size_t runEnd = symbol;
+            while ((runEnd < codeLengths.size()) && (codeLengths[runEnd] == 0))
+            {
+                ++runEnd;
+            }
+            return runEnd - symbol;
+        }
+    } // namespace
+
+    /**
+     * Get number of bits of the compact code lengths header.
+     * @param codeLengths Code length of every symbol.
+     * @param tokenBits Number of bits of the single code length.
+     * @return Number of header bits.
+     */
+    inline std::size_t code_lengths_header_bits(const std::vector<azgra::byte> &codeLengths,
+                                                const azgra::byte tokenBits = HUFFMAN_HEADER_NIBBLE_BITS)
+    {
+        std::size_t tokenCount = 0;
+        std::size_t symbol = 0;
+        while (symbol < codeLengths.size())
+        {
+            if (codeLengths[symbol] > 0)
+            {
+                ++tokenCount;
+                ++symbol;
+                continue;
+            }
+            const std::size_t runLength = unused_run_length(codeLengths, symbol);
+            tokenCount += 1 + token_varint_size(runLength - 1, tokenBits);
+            symbol += runLength;
+        }
+        return tokenCount * tokenBits;
+    }
+
+    /**
+     * Write the compact code lengths header. Every used symbol takes one token with its code length,
+     * run of unused symbols is written as zero token followed by the run length, so sparse alphabets stay cheap.
+     * @param stream Output bit stream.
+     * @param codeLengths Code length of every symbol, less than (1 << tokenBits).
+     * @param tokenBits Number of bits of the single code length.
+     */
+    inline void write_code_lengths(OutWordBitStream &stream,
+                                   const std::vector<azgra::byte> &codeLengths,
+                                   const azgra::byte tokenBits = HUFFMAN_HEADER_NIBBLE_BITS)
+    {
+        std::size_t symbol = 0;
+        while (symbol < codeLengths.size())
+        {
+            const azgra::byte length = codeLengths[symbol];
+            if (length > 0)
+            {
+                always_assert(length < (1u << tokenBits));
+                stream.write_bits(length, tokenBits);
+                ++symbol;
+                continue;
+            }
+            const std::size_t runLength = unused_run_length(codeLengths, symbol);
+            stream.write_bits(0, tokenBits);
+            write_token_varint(stream, runLength - 1, tokenBits);
+            symbol += runLength;
+        }
+    }
+
+    /**
+     * Read the compact code lengths header.
+     * @param stream Input bit stream.
+     * @param alphabetSize Size of the alphabet.
+     * @param tokenBits Number of bits of the single code length.
+     * @return Code length of every symbol.
+     */
+    inline std::vector<azgra::byte> read_code_lengths(InWordBitStream &stream,
+                                                      const std::size_t alphabetSize,
+                                                      const azgra::byte tokenBits = HUFFMAN_HEADER_NIBBLE_BITS)
+    {
+        std::vector<azgra::byte> codeLengths(alphabetSize, 0);
+        std::size_t symbol = 0;
+        while (symbol < alphabetSize)
+        {
+            const auto length = static_cast<azgra::byte>(stream.read_bits(tokenBits));
+            if (length > 0)
+            {
+                codeLengths[symbol++] = length;
+                continue;
+            }
+            const std::size_t runLength = read_token_varint(stream, tokenBits) + 1;
+            always_assert(runLength <= (alphabetSize - symbol) && "Corrupted code lengths header.");
+            symbol += runLength;
+        }
+        return codeLengths;
+    }
+
 } // namespace huffman
\ No newline at end of file
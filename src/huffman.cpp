@@ -1,80 +1,770 @@
 #include <queue>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <cmath>
 #include "huffman.h"
+#include "adaptive_huffman.h"
+#include "large_alphabet_huffman.h"
+#include "word_huffman.h"
 
+/**
+ * Count occurrences of every byte of the text.
+ * @param text Text.
+ * @return Occurrence count of every byte.
+ */
+static std::array<std::size_t, 256> get_byte_histogram(const azgra::StringView text)
+{
+    std::array<std::size_t, 256> histogram{};
+    for (const char symbol : text)
+    {
+        ++histogram[huffman::symbol_index(symbol)];
+    }
+    return histogram;
+}
+
+/**
+ * Get length-limited code lengths of the byte alphabet from the histogram.
+ * @param histogram Occurrence count of every byte.
+ * @return Code length of every byte.
+ */
+static std::vector<azgra::byte> get_byte_code_lengths(const std::array<std::size_t, 256> &histogram)
+{
+    std::vector<azgra::byte> codeLengths(histogram.size());
+    huffman::HuffmanCodeLengthBuilder().build(histogram.data(), histogram.size(),
+                                              huffman::HUFFMAN_LIMITED_CODE_LENGTH, codeLengths.data());
+    return codeLengths;
+}
 
-inline void write_code(azgra::io::stream::OutMemoryBitStream &stream, const std::vector<bool> &code)
+/**
+ * Get number of bits of the encoded text.
+ * @param histogram Occurrence count of every byte.
+ * @param codeLengths Code length of every byte.
+ * @return Number of payload bits.
+ */
+static std::size_t get_payload_bits(const std::array<std::size_t, 256> &histogram, const std::vector<azgra::byte> &codeLengths)
 {
-    for (const bool bit : code)
+    std::size_t payloadBits = 0;
+    for (std::size_t symbol = 0; symbol < histogram.size(); ++symbol)
     {
-        stream << bit;
+        payloadBits += histogram[symbol] * codeLengths[symbol];
     }
+    return payloadBits;
 }
 
-void huffman_encode(azgra::io::stream::OutMemoryBitStream &stream,
-                    const huffman::HuffmanTree<azgra::StringView::value_type> &huffman,
-                    const azgra::StringView textToEncode)
+/**
+ * Encode bytes with the canonical code.
+ * @param stream Output bit stream.
+ * @param codes Code of every byte.
+ * @param text Bytes to encode.
+ * @param textSize Number of bytes.
+ */
+static void encode_bytes(OutWordBitStream &stream,
+                         const huffman::HuffmanCode *codes,
+                         const char *text,
+                         const std::size_t textSize)
 {
-    // write number of symbols
-    const size_t symbolCount = huffman.symbols.size();
-    stream.write_value(symbolCount);
+    // NOTE(Moravec): Codes are limited to 15 bits, so two codes always fit into single write.
+    static_assert((2 * huffman::HUFFMAN_LIMITED_CODE_LENGTH) <= 32);
+    std::size_t i = 0;
+    for (; i + 2 <= textSize; i += 2)
+    {
+        const huffman::HuffmanCode &first = codes[huffman::symbol_index(text[i])];
+        const huffman::HuffmanCode &second = codes[huffman::symbol_index(text[i + 1])];
+        stream.write_bits((static_cast<uint64_t>(first.bits) << second.length) | second.bits,
+                          first.length + second.length);
+    }
+    if (i < textSize)
+    {
+        const huffman::HuffmanCode &last = codes[huffman::symbol_index(text[i])];
+        stream.write_bits(last.bits, last.length);
+    }
+}
 
-    // Write symbol and its occurrence count so we can build huffman tree when decompressing
-    for (const auto&[symbol, info] : huffman.symbols)
+/**
+ * Decode bytes with the decode table.
+ * @param table Decode table.
+ * @param stream Input bit stream.
+ * @param decoded Output buffer.
+ * @param symbolCount Number of bytes to decode.
+ */
+static void decode_bytes(const huffman::HuffmanDecodeTable &table,
+                         InWordBitStream &stream,
+                         char *decoded,
+                         const std::size_t symbolCount)
+{
+    const std::size_t symbolsPerRefill = huffman::symbols_per_refill(table);
+    std::size_t i = 0;
+    while (i + symbolsPerRefill <= symbolCount)
     {
-        stream.write_value(symbol);
-        stream.write_value<uint16_t>(info.occurrenceCount);
+        stream.refill();
+        for (std::size_t s = 0; s < symbolsPerRefill; ++s)
+        {
+            decoded[i++] = static_cast<char>(huffman::decode_symbol(table, stream));
+        }
+    }
+    for (; i < symbolCount; ++i)
+    {
+        stream.refill();
+        decoded[i] = static_cast<char>(huffman::decode_symbol(table, stream));
     }
+}
+
+azgra::ByteArray huffman_encode_canonical(const azgra::StringView textToEncode)
+{
+    const auto histogram = get_byte_histogram(textToEncode);
+    const auto codeLengths = get_byte_code_lengths(histogram);
+    const huffman::CanonicalHuffmanCode canonicalCode = huffman::create_canonical_code(codeLengths);
 
-    // Write text size
-    stream.write_value(static_cast<size_t>(textToEncode.size()));
+    const std::size_t payloadBits = get_payload_bits(histogram, codeLengths);
+    OutWordBitStream stream(sizeof(uint64_t) + ((huffman::code_lengths_header_bits(codeLengths) + payloadBits + 7) / 8));
+    stream.write_value(static_cast<uint64_t>(textToEncode.size()));
+    huffman::write_code_lengths(stream, codeLengths);
 
-    // Encode text
-    for (const char symbol : textToEncode)
+    encode_bytes(stream, canonicalCode.codes.data(), textToEncode.data(), textToEncode.size());
+    return stream.get_flushed_buffer();
+}
+
+std::string huffman_decode_canonical(const azgra::ByteArray &encodedBytes)
+{
+    InWordBitStream stream(encodedBytes.data(), encodedBytes.size());
+    const auto expectedSymbolCount = stream.read_value<uint64_t>();
+    const auto codeLengths = huffman::read_code_lengths(stream, 256);
+
+    std::string decodedText(expectedSymbolCount, '\0');
+    if (expectedSymbolCount == 0)
+        return decodedText;
+
+    const huffman::HuffmanDecodeTable table = huffman::create_decode_table(codeLengths);
+    decode_bytes(table, stream, decodedText.data(), expectedSymbolCount);
+    return decodedText;
+}
+
+/**
+ * Get size of the interleaved stream segment. Every stream except the last one encodes this many symbols.
+ * @param symbolCount Total number of symbols.
+ * @return Number of symbols per stream.
+ */
+static std::size_t get_interleaved_segment_size(const std::size_t symbolCount)
+{
+    return (symbolCount + HUFFMAN_INTERLEAVED_STREAM_COUNT - 1) / HUFFMAN_INTERLEAVED_STREAM_COUNT;
+}
+
+/**
+ * Encode bytes into interleaved streams. Output starts with the jump table, the last stream size is implied.
+ * @param codes Code of every byte.
+ * @param text Bytes to encode.
+ * @param textSize Number of bytes.
+ * @param payloadBits Expected number of encoded bits, used to pre-size the streams.
+ * @return Jump table followed by the streams.
+ */
+static azgra::ByteArray encode_interleaved_streams(const huffman::HuffmanCode *codes,
+                                                   const char *text,
+                                                   const std::size_t textSize,
+                                                   const std::size_t payloadBits)
+{
+    const std::size_t segmentSize = get_interleaved_segment_size(textSize);
+    const std::size_t expectedStreamSize = (payloadBits / 8) / HUFFMAN_INTERLEAVED_STREAM_COUNT;
+
+    std::array<azgra::ByteArray, HUFFMAN_INTERLEAVED_STREAM_COUNT> streams;
+    for (std::size_t streamIndex = 0; streamIndex < HUFFMAN_INTERLEAVED_STREAM_COUNT; ++streamIndex)
+    {
+        const std::size_t segmentBegin = std::min(streamIndex * segmentSize, textSize);
+        const std::size_t segmentEnd = std::min(segmentBegin + segmentSize, textSize);
+
+        OutWordBitStream segmentStream(expectedStreamSize + 64);
+        encode_bytes(segmentStream, codes, text + segmentBegin, segmentEnd - segmentBegin);
+        streams[streamIndex] = segmentStream.get_flushed_buffer();
+    }
+
+    OutWordBitStream jumpTableStream;
+    for (std::size_t streamIndex = 0; streamIndex < HUFFMAN_INTERLEAVED_STREAM_COUNT - 1; ++streamIndex)
+    {
+        jumpTableStream.write_value(static_cast<uint64_t>(streams[streamIndex].size()));
+    }
+
+    azgra::ByteArray encodedBytes = jumpTableStream.get_flushed_buffer();
+    for (const auto &stream : streams)
+    {
+        encodedBytes.insert(encodedBytes.end(), stream.begin(), stream.end());
+    }
+    return encodedBytes;
+}
+
+/**
+ * Decode bytes from the interleaved streams.
+ * @param table Decode table.
+ * @param encodedData Jump table followed by the streams.
+ * @param encodedSize Size of the encoded data.
+ * @param decodedText Output buffer.
+ * @param symbolCount Number of bytes to decode.
+ */
+static void decode_interleaved_streams(const huffman::HuffmanDecodeTable &table,
+                                       const azgra::byte *encodedData,
+                                       const std::size_t encodedSize,
+                                       char *decodedText,
+                                       const std::size_t symbolCount)
+{
+    std::array<std::size_t, HUFFMAN_INTERLEAVED_STREAM_COUNT> streamSizes{};
+    InWordBitStream jumpTableStream(encodedData, encodedSize);
+    for (std::size_t streamIndex = 0; streamIndex < HUFFMAN_INTERLEAVED_STREAM_COUNT - 1; ++streamIndex)
+    {
+        streamSizes[streamIndex] = jumpTableStream.read_value<uint64_t>();
+    }
+
+    std::size_t streamOffset = jumpTableStream.consumed_bytes();
+    const std::size_t lastStreamIndex = HUFFMAN_INTERLEAVED_STREAM_COUNT - 1;
+    std::array<InWordBitStream, HUFFMAN_INTERLEAVED_STREAM_COUNT> streams;
+    std::array<char *, HUFFMAN_INTERLEAVED_STREAM_COUNT> decoded{};
+    std::array<std::size_t, HUFFMAN_INTERLEAVED_STREAM_COUNT> symbolCounts{};
+    const std::size_t segmentSize = get_interleaved_segment_size(symbolCount);
+    for (std::size_t streamIndex = 0; streamIndex < HUFFMAN_INTERLEAVED_STREAM_COUNT; ++streamIndex)
+    {
+        if (streamIndex == lastStreamIndex)
+        {
+            always_assert(streamOffset <= encodedSize);
+            streamSizes[streamIndex] = encodedSize - streamOffset;
+        }
+        always_assert(streamOffset + streamSizes[streamIndex] <= encodedSize);
+        streams[streamIndex] = InWordBitStream(encodedData + streamOffset, streamSizes[streamIndex]);
+        streamOffset += streamSizes[streamIndex];
+
+        const std::size_t segmentBegin = std::min(streamIndex * segmentSize, symbolCount);
+        decoded[streamIndex] = decodedText + segmentBegin;
+        symbolCounts[streamIndex] = std::min(segmentBegin + segmentSize, symbolCount) - segmentBegin;
+    }
+
+    const std::size_t symbolsPerRefill = huffman::symbols_per_refill(table);
+
+    // All streams are advanced in the same loop, the last stream is the shortest one.
+    static_assert(HUFFMAN_INTERLEAVED_STREAM_COUNT == 4);
+    std::size_t i = 0;
+    while (i + symbolsPerRefill <= symbolCounts[lastStreamIndex])
     {
-        write_code(stream, huffman.symbols.at(symbol).code);
+        streams[0].refill();
+        streams[1].refill();
+        streams[2].refill();
+        streams[3].refill();
+        for (std::size_t s = 0; s < symbolsPerRefill; ++s, ++i)
+        {
+            decoded[0][i] = static_cast<char>(huffman::decode_symbol(table, streams[0]));
+            decoded[1][i] = static_cast<char>(huffman::decode_symbol(table, streams[1]));
+            decoded[2][i] = static_cast<char>(huffman::decode_symbol(table, streams[2]));
+            decoded[3][i] = static_cast<char>(huffman::decode_symbol(table, streams[3]));
+        }
+    }
+
+    for (std::size_t streamIndex = 0; streamIndex < HUFFMAN_INTERLEAVED_STREAM_COUNT; ++streamIndex)
+    {
+        decode_bytes(table, streams[streamIndex], decoded[streamIndex] + i, symbolCounts[streamIndex] - i);
     }
 }
 
-static huffman::HuffmanTree<char> decode_huffman_tree_from_stream(azgra::io::stream::InMemoryBitStream &stream,
-                                                                  const size_t symbolCount)
+azgra::ByteArray huffman_encode_interleaved(const azgra::StringView textToEncode)
 {
-    std::vector<std::pair<char, size_t>> symbols(symbolCount);
-    char symbol;
-    uint16_t symbolOccurrence;
+    const auto histogram = get_byte_histogram(textToEncode);
+    const auto codeLengths = get_byte_code_lengths(histogram);
+    const huffman::CanonicalHuffmanCode canonicalCode = huffman::create_canonical_code(codeLengths);
+
+    OutWordBitStream headerStream;
+    headerStream.write_value(static_cast<uint64_t>(textToEncode.size()));
+    huffman::write_code_lengths(headerStream, codeLengths);
 
-    for (size_t sId = 0; sId < symbolCount; ++sId)
+    azgra::ByteArray encodedBytes = headerStream.get_flushed_buffer();
+    const azgra::ByteArray streams = encode_interleaved_streams(canonicalCode.codes.data(),
+                                                                textToEncode.data(),
+                                                                textToEncode.size(),
+                                                                get_payload_bits(histogram, codeLengths));
+    encodedBytes.insert(encodedBytes.end(), streams.begin(), streams.end());
+    return encodedBytes;
+}
+
+std::string huffman_decode_interleaved(const azgra::ByteArray &encodedBytes)
+{
+    InWordBitStream headerStream(encodedBytes.data(), encodedBytes.size());
+    const auto expectedSymbolCount = headerStream.read_value<uint64_t>();
+    const auto codeLengths = huffman::read_code_lengths(headerStream, 256);
+
+    std::string decodedText(expectedSymbolCount, '\0');
+    if (expectedSymbolCount == 0)
+        return decodedText;
+
+    const std::size_t headerSize = headerStream.consumed_bytes();
+    const huffman::HuffmanDecodeTable table = huffman::create_decode_table(codeLengths);
+    decode_interleaved_streams(table, encodedBytes.data() + headerSize, encodedBytes.size() - headerSize,
+                               decodedText.data(), expectedSymbolCount);
+    return decodedText;
+}
+
+/**
+ * Code table of the single block.
+ */
+struct HuffmanBlockTable
+{
+    std::array<std::size_t, 256> histogram{};
+    std::vector<azgra::byte> codeLengths;
+    /**
+     * Index of the block, whose table is used to encode this block.
+     */
+    std::size_t tableBlockIndex{0};
+};
+
+azgra::ByteArray huffman_encode_blocks(const azgra::StringView textToEncode, const std::size_t blockSize)
+{
+    always_assert(blockSize > 0);
+    const std::size_t textSize = textToEncode.size();
+    const auto blockCount = static_cast<long>((textSize + blockSize - 1) / blockSize);
+
+    // Build histogram and code lengths of every block.
+    std::vector<HuffmanBlockTable> blockTables(blockCount);
+#pragma omp parallel for default(none) shared(blockTables, textToEncode) firstprivate(blockCount, blockSize, textSize) schedule(dynamic)
+    for (long block = 0; block < blockCount; ++block)
     {
-        symbol = stream.read_value<char>();
-        symbolOccurrence = stream.read_value<uint16_t>();
+        const std::size_t blockBegin = block * blockSize;
+        const std::size_t blockLength = std::min(blockSize, textSize - blockBegin);
+        HuffmanBlockTable &blockTable = blockTables[block];
+        blockTable.histogram = get_byte_histogram(textToEncode.substr(blockBegin, blockLength));
+        blockTable.codeLengths = get_byte_code_lengths(blockTable.histogram);
+        blockTable.tableBlockIndex = block;
+    }
 
-        symbols[sId] = {symbol, symbolOccurrence};
+    // Reuse the table of the previous block, if it codes all the symbols and it is cheaper than storing own table.
+    for (long block = 1; block < blockCount; ++block)
+    {
+        HuffmanBlockTable &blockTable = blockTables[block];
+        const std::size_t previousTableIndex = blockTables[block - 1].tableBlockIndex;
+        const auto &previousLengths = blockTables[previousTableIndex].codeLengths;
+
+        bool codesAllSymbols = true;
+        for (std::size_t symbol = 0; symbol < blockTable.histogram.size(); ++symbol)
+        {
+            codesAllSymbols &= (blockTable.histogram[symbol] == 0) || (previousLengths[symbol] > 0);
+        }
+        if (!codesAllSymbols)
+            continue;
+
+        const std::size_t ownCost = get_payload_bits(blockTable.histogram, blockTable.codeLengths) +
+                                    huffman::code_lengths_header_bits(blockTable.codeLengths);
+        const std::size_t reuseCost = get_payload_bits(blockTable.histogram, previousLengths);
+        if (reuseCost <= ownCost)
+        {
+            blockTable.tableBlockIndex = previousTableIndex;
+        }
+    }
+
+    // Encode blocks.
+    std::vector<azgra::ByteArray> encodedBlocks(blockCount);
+#pragma omp parallel for default(none) shared(blockTables, encodedBlocks, textToEncode) firstprivate(blockCount, blockSize, textSize) schedule(dynamic)
+    for (long block = 0; block < blockCount; ++block)
+    {
+        const std::size_t blockBegin = block * blockSize;
+        const std::size_t blockLength = std::min(blockSize, textSize - blockBegin);
+        const HuffmanBlockTable &blockTable = blockTables[block];
+        const bool ownTable = (blockTable.tableBlockIndex == static_cast<std::size_t>(block));
+        const auto &codeLengths = blockTables[blockTable.tableBlockIndex].codeLengths;
+        const huffman::CanonicalHuffmanCode canonicalCode = huffman::create_canonical_code(codeLengths);
+
+        OutWordBitStream blockHeaderStream;
+        blockHeaderStream.write_value(ownTable ? HUFFMAN_BLOCK_OWN_TABLE : HUFFMAN_BLOCK_PREVIOUS_TABLE);
+        if (ownTable)
+        {
+            huffman::write_code_lengths(blockHeaderStream, codeLengths);
+        }
+
+        encodedBlocks[block] = blockHeaderStream.get_flushed_buffer();
+        const azgra::ByteArray streams = encode_interleaved_streams(canonicalCode.codes.data(),
+                                                                    textToEncode.data() + blockBegin,
+                                                                    blockLength,
+                                                                    get_payload_bits(blockTable.histogram, codeLengths));
+        encodedBlocks[block].insert(encodedBlocks[block].end(), streams.begin(), streams.end());
+    }
+
+    // Header with the block index.
+    OutWordBitStream headerStream;
+    headerStream.write_value(static_cast<uint64_t>(textSize));
+    headerStream.write_value(static_cast<uint64_t>(blockSize));
+    for (const auto &encodedBlock : encodedBlocks)
+    {
+        headerStream.write_value(static_cast<uint64_t>(encodedBlock.size()));
     }
 
-    return huffman::build_huffman_tree(symbols);
+    azgra::ByteArray encodedBytes = headerStream.get_flushed_buffer();
+    for (const auto &encodedBlock : encodedBlocks)
+    {
+        encodedBytes.insert(encodedBytes.end(), encodedBlock.begin(), encodedBlock.end());
+    }
+    return encodedBytes;
 }
 
-std::string huffman_decode(azgra::io::stream::InMemoryBitStream &stream)
+std::string huffman_decode_blocks(const azgra::ByteArray &encodedBytes)
 {
-    const auto symbolCount = stream.read_value<size_t>();
-    const huffman::HuffmanTree<std::string::value_type> huffman = decode_huffman_tree_from_stream(stream, symbolCount);
+    InWordBitStream headerStream(encodedBytes.data(), encodedBytes.size());
+    const auto textSize = static_cast<std::size_t>(headerStream.read_value<uint64_t>());
+    const auto blockSize = static_cast<std::size_t>(headerStream.read_value<uint64_t>());
+    const auto blockCount = static_cast<long>((blockSize > 0) ? ((textSize + blockSize - 1) / blockSize) : 0);
 
-    const auto expectedSymbolCount = stream.read_value<size_t>();
-    std::vector<char> decodedBytes(expectedSymbolCount);
+    std::vector<std::size_t> blockOffsets(blockCount + 1);
+    for (long block = 0; block < blockCount; ++block)
+    {
+        blockOffsets[block + 1] = blockOffsets[block] + headerStream.read_value<uint64_t>();
+    }
+    const std::size_t headerSize = headerStream.consumed_bytes();
+    always_assert(headerSize + blockOffsets[blockCount] <= encodedBytes.size());
 
-    bool bit;
-    std::shared_ptr<huffman::HuffmanNode<char>> currentNode;
-    for (size_t i = 0; i < expectedSymbolCount; ++i)
+    // Read block tables, blocks without own table refer to the previous one.
+    std::vector<huffman::HuffmanDecodeTable> tables;
+    std::vector<std::size_t> blockTableIndices(blockCount);
+    std::vector<std::size_t> streamOffsets(blockCount);
+    for (long block = 0; block < blockCount; ++block)
     {
-        currentNode = huffman.root;
-        while (!currentNode->isLeaf)
+        const std::size_t blockOffset = headerSize + blockOffsets[block];
+        InWordBitStream blockHeaderStream(encodedBytes.data() + blockOffset, blockOffsets[block + 1] - blockOffsets[block]);
+        const auto tableFlag = blockHeaderStream.read_value<azgra::byte>();
+        if (tableFlag == HUFFMAN_BLOCK_OWN_TABLE)
         {
-            bit = stream.read_bit();
-            currentNode = currentNode->navigate(bit);
+            tables.push_back(huffman::create_decode_table(huffman::read_code_lengths(blockHeaderStream, 256)));
         }
-        decodedBytes[i] = currentNode->symbol;
-        // decode code
+        always_assert(!tables.empty() && "First block has to have its own table.");
+        blockTableIndices[block] = tables.size() - 1;
+        streamOffsets[block] = blockOffset + blockHeaderStream.consumed_bytes();
     }
 
+    std::string decodedText(textSize, '\0');
+#pragma omp parallel for default(none) shared(tables, blockTableIndices, streamOffsets, blockOffsets, encodedBytes, decodedText) firstprivate(blockCount, blockSize, textSize, headerSize) schedule(dynamic)
+    for (long block = 0; block < blockCount; ++block)
+    {
+        const std::size_t blockBegin = block * blockSize;
+        const std::size_t blockLength = std::min(blockSize, textSize - blockBegin);
+        const std::size_t blockEnd = headerSize + blockOffsets[block + 1];
+        decode_interleaved_streams(tables[blockTableIndices[block]],
+                                   encodedBytes.data() + streamOffsets[block],
+                                   blockEnd - streamOffsets[block],
+                                   decodedText.data() + blockBegin,
+                                   blockLength);
+    }
+    return decodedText;
+}
 
-    return std::string(reinterpret_cast<char const *>(decodedBytes.data()), decodedBytes.size());
-}
\ No newline at end of file
+/**
+ * Get number of bits of the histogram coded with the ideal entropy code.
+ * @param histogram Occurrence count of every byte.
+ * @return Number of bits.
+ */
+static double get_entropy_bits(const std::array<std::size_t, 256> &histogram)
+{
+    std::size_t totalCount = 0;
+    double bits = 0.0;
+    for (const std::size_t count : histogram)
+    {
+        if (count == 0)
+            continue;
+        totalCount += count;
+        bits -= static_cast<double>(count) * std::log2(static_cast<double>(count));
+    }
+    if (totalCount > 0)
+    {
+        bits += static_cast<double>(totalCount) * std::log2(static_cast<double>(totalCount));
+    }
+    return bits;
+}
+
+/**
+ * Group of contexts sharing the code table.
+ */
+struct HuffmanContextCluster
+{
+    std::array<std::size_t, 256> histogram{};
+    double entropyBits{0.0};
+};
+
+/**
+ * Assign contexts to the shared code tables. Contexts are visited from the most frequent one, every context either
+ * gets its own table or joins the cluster, whose cost grows the least, if that is cheaper than the header of own table.
+ * @param contextHistograms Histogram of the bytes following every context.
+ * @param contextMap Table index of every context.
+ * @return Clusters of the contexts.
+ */
+static std::vector<HuffmanContextCluster> cluster_contexts(const std::vector<std::array<std::size_t, 256>> &contextHistograms,
+                                                           std::array<azgra::byte, 256> &contextMap)
+{
+    std::array<std::size_t, 256> contextCounts{};
+    std::array<std::size_t, 256> contextOrder{};
+    for (std::size_t context = 0; context < 256; ++context)
+    {
+        contextOrder[context] = context;
+        for (const std::size_t count : contextHistograms[context])
+        {
+            contextCounts[context] += count;
+        }
+    }
+    std::stable_sort(contextOrder.begin(), contextOrder.end(), [&contextCounts](const std::size_t a, const std::size_t b)
+    {
+        return contextCounts[a] > contextCounts[b];
+    });
+
+    std::vector<HuffmanContextCluster> clusters;
+    contextMap.fill(0);
+    for (const std::size_t context : contextOrder)
+    {
+        if (contextCounts[context] == 0)
+            break;
+        const auto &histogram = contextHistograms[context];
+        const double ownBits = get_entropy_bits(histogram);
+        const double ownTableBits = ownBits + static_cast<double>(huffman::code_lengths_header_bits(get_byte_code_lengths(histogram)));
+
+        std::size_t bestCluster = clusters.size();
+        double bestMergeBits = 0.0;
+        HuffmanContextCluster merged;
+        for (std::size_t cluster = 0; cluster < clusters.size(); ++cluster)
+        {
+            for (std::size_t symbol = 0; symbol < 256; ++symbol)
+            {
+                merged.histogram[symbol] = clusters[cluster].histogram[symbol] + histogram[symbol];
+            }
+            const double mergeBits = get_entropy_bits(merged.histogram) - clusters[cluster].entropyBits;
+            if ((bestCluster == clusters.size()) || (mergeBits < bestMergeBits))
+            {
+                bestCluster = cluster;
+                bestMergeBits = mergeBits;
+            }
+        }
+
+        const bool canAddCluster = clusters.size() < HUFFMAN_CONTEXT_MAX_TABLES;
+        if ((bestCluster == clusters.size()) || (canAddCluster && (ownTableBits < bestMergeBits)))
+        {
+            HuffmanContextCluster cluster;
+            cluster.histogram = histogram;
+            cluster.entropyBits = ownBits;
+            contextMap[context] = static_cast<azgra::byte>(clusters.size());
+            clusters.push_back(cluster);
+            continue;
+        }
+
+        HuffmanContextCluster &cluster = clusters[bestCluster];
+        for (std::size_t symbol = 0; symbol < 256; ++symbol)
+        {
+            cluster.histogram[symbol] += histogram[symbol];
+        }
+        cluster.entropyBits = get_entropy_bits(cluster.histogram);
+        contextMap[context] = static_cast<azgra::byte>(bestCluster);
+    }
+    return clusters;
+}
+
+azgra::ByteArray huffman_encode_context(const azgra::StringView textToEncode)
+{
+    // NOTE(Moravec): The first byte is coded in the context of zero byte.
+    std::vector<std::array<std::size_t, 256>> contextHistograms(256);
+    std::size_t previous = 0;
+    for (const char symbol : textToEncode)
+    {
+        const std::size_t symbolIndex = huffman::symbol_index(symbol);
+        ++contextHistograms[previous][symbolIndex];
+        previous = symbolIndex;
+    }
+
+    std::array<azgra::byte, 256> contextMap{};
+    const auto clusters = cluster_contexts(contextHistograms, contextMap);
+
+    OutWordBitStream stream(sizeof(uint64_t) + 256 + textToEncode.size());
+    stream.write_value(static_cast<uint64_t>(textToEncode.size()));
+    stream.write_value(static_cast<azgra::byte>(clusters.size()));
+    for (const azgra::byte tableIndex : contextMap)
+    {
+        stream.write_value(tableIndex);
+    }
+
+    std::vector<huffman::CanonicalHuffmanCode> canonicalCodes(clusters.size());
+    for (std::size_t cluster = 0; cluster < clusters.size(); ++cluster)
+    {
+        const auto codeLengths = get_byte_code_lengths(clusters[cluster].histogram);
+        huffman::write_code_lengths(stream, codeLengths);
+        canonicalCodes[cluster] = huffman::create_canonical_code(codeLengths);
+    }
+
+    std::array<const huffman::HuffmanCode *, 256> contextCodes{};
+    for (std::size_t context = 0; context < 256; ++context)
+    {
+        if (!canonicalCodes.empty())
+        {
+            contextCodes[context] = canonicalCodes[contextMap[context]].codes.data();
+        }
+    }
+
+    previous = 0;
+    for (const char symbol : textToEncode)
+    {
+        const std::size_t symbolIndex = huffman::symbol_index(symbol);
+        const huffman::HuffmanCode &code = contextCodes[previous][symbolIndex];
+        stream.write_bits(code.bits, code.length);
+        previous = symbolIndex;
+    }
+    return stream.get_flushed_buffer();
+}
+
+std::string huffman_decode_context(const azgra::ByteArray &encodedBytes)
+{
+    InWordBitStream stream(encodedBytes.data(), encodedBytes.size());
+    const auto expectedSymbolCount = stream.read_value<uint64_t>();
+    const auto tableCount = stream.read_value<azgra::byte>();
+    std::array<azgra::byte, 256> contextMap{};
+    for (auto &tableIndex : contextMap)
+    {
+        tableIndex = stream.read_value<azgra::byte>();
+        always_assert((tableCount == 0) || (tableIndex < tableCount));
+    }
+
+    std::string decodedText(expectedSymbolCount, '\0');
+    if (expectedSymbolCount == 0)
+        return decodedText;
+
+    std::vector<huffman::HuffmanDecodeTable> tables(tableCount);
+    azgra::byte maxCodeLength = 1;
+    for (auto &table : tables)
+    {
+        table = huffman::create_decode_table(huffman::read_code_lengths(stream, 256));
+        maxCodeLength = std::max(maxCodeLength, table.maxCodeLength);
+    }
+    always_assert(!tables.empty());
+
+    std::array<const huffman::HuffmanDecodeTable *, 256> contextTables{};
+    for (std::size_t context = 0; context < 256; ++context)
+    {
+        contextTables[context] = &tables[contextMap[context]];
+    }
+
+    const std::size_t symbolsPerRefill = std::max<std::size_t>(1, 56 / maxCodeLength);
+    char *decoded = decodedText.data();
+    uint16_t previous = 0;
+    std::size_t i = 0;
+    while (i + symbolsPerRefill <= expectedSymbolCount)
+    {
+        stream.refill();
+        for (std::size_t s = 0; s < symbolsPerRefill; ++s)
+        {
+            previous = huffman::decode_symbol(*contextTables[previous], stream);
+            decoded[i++] = static_cast<char>(previous);
+        }
+    }
+    for (; i < expectedSymbolCount; ++i)
+    {
+        stream.refill();
+        previous = huffman::decode_symbol(*contextTables[previous], stream);
+        decoded[i] = static_cast<char>(previous);
+    }
+    return decodedText;
+}
+
+using HuffmanClock = std::chrono::high_resolution_clock;
+
+static double elapsed_seconds(const HuffmanClock::time_point start)
+{
+    const std::chrono::duration<double> elapsed = HuffmanClock::now() - start;
+    return elapsed.count();
+}
+
+static void report_huffman_result(const char *coder,
+                                  const std::size_t originalSize,
+                                  const std::size_t encodedSize,
+                                  const double encodeSeconds,
+                                  const double decodeSeconds,
+                                  const bool equal)
+{
+    const double megaBytes = static_cast<double>(originalSize) / (1024.0 * 1024.0);
+    const double bps = static_cast<double>(encodedSize * 8) / static_cast<double>(originalSize);
+    azgra::print_colorized(equal ? azgra::ConsoleColor::ConsoleColor_Green : azgra::ConsoleColor::ConsoleColor_Red,
+                           "%s\tSize: %lu\tEnc.Size: %lu\tBPS: %.4f\tEncode: %.2f MB/s\tDecode: %.2f MB/s\n",
+                           coder, originalSize, encodedSize, bps, megaBytes / encodeSeconds, megaBytes / decodeSeconds);
+}
+
+/**
+ * Measure round trip of the byte coder.
+ * @param coder Name of the coder.
+ * @param text Text to encode.
+ * @param encode Encode function.
+ * @param decode Decode function.
+ */
+template<typename EncodeFunction, typename DecodeFunction>
+static void test_huffman_coder(const char *coder,
+                               const std::string &text,
+                               EncodeFunction &&encode,
+                               DecodeFunction &&decode)
+{
+    auto start = HuffmanClock::now();
+    const azgra::ByteArray encodedBytes = encode(azgra::StringView(text));
+    const double encodeSeconds = elapsed_seconds(start);
+
+    start = HuffmanClock::now();
+    const std::string decoded = decode(encodedBytes);
+    const double decodeSeconds = elapsed_seconds(start);
+
+    report_huffman_result(coder, text.size(), encodedBytes.size(), encodeSeconds, decodeSeconds, decoded == text);
+}
+
+void test_huffman(const char *inputFile)
+{
+    const auto text = azgra::io::read_text_file(inputFile);
+    fprintf(stdout, "File: %s\n", inputFile);
+
+    test_huffman_coder("Canonical", text, huffman_encode_canonical, huffman_decode_canonical);
+    test_huffman_coder("Interleaved", text, huffman_encode_interleaved, huffman_decode_interleaved);
+    test_huffman_coder("Blocks", text, [](const azgra::StringView textView)
+    {
+        return huffman_encode_blocks(textView);
+    }, huffman_decode_blocks);
+    test_huffman_coder("Adaptive", text, [](const azgra::StringView textView)
+    {
+        std::istringstream input{std::string(textView)};
+        std::ostringstream output;
+        huffman_encode_adaptive(input, output);
+        const std::string encoded = output.str();
+        return azgra::ByteArray(encoded.begin(), encoded.end());
+    }, [](const azgra::ByteArray &encodedBytes)
+    {
+        std::istringstream input{std::string(encodedBytes.begin(), encodedBytes.end())};
+        std::ostringstream output;
+        huffman_decode_adaptive(input, output);
+        return output.str();
+    });
+    test_huffman_coder("Adaptive 251B chunks", text, [](const azgra::StringView textView)
+    {
+        std::istringstream input{std::string(textView)};
+        std::ostringstream output;
+        huffman_encode_adaptive(input, output);
+        const std::string encoded = output.str();
+        return azgra::ByteArray(encoded.begin(), encoded.end());
+    }, [](const azgra::ByteArray &encodedBytes)
+    {
+        // NOTE(Moravec): Small odd chunks split the codes at the chunk end, also right after the code rebuild.
+        std::istringstream input{std::string(encodedBytes.begin(), encodedBytes.end())};
+        std::ostringstream output;
+        huffman_decode_adaptive(input, output, 251);
+        return output.str();
+    });
+    test_huffman_coder("Context", text, huffman_encode_context, huffman_decode_context);
+    test_huffman_coder("Words", text, huffman_encode_words, huffman_decode_words);
+}
+
+void test_huffman_symbols(const char *inputFile)
+{
+    std::vector<uint16_t> samples;
+    std::ifstream input(inputFile);
+    always_assert(input.is_open() && "Failed to open the input file.");
+    uint32_t sample;
+    while (input >> sample)
+    {
+        samples.push_back(static_cast<uint16_t>(sample));
+    }
+    fprintf(stdout, "File: %s\tSamples: %lu\n", inputFile, samples.size());
+
+    auto start = HuffmanClock::now();
+    const azgra::ByteArray encodedBytes = huffman_encode_symbols(samples);
+    const double encodeSeconds = elapsed_seconds(start);
+
+    start = HuffmanClock::now();
+    const std::vector<uint16_t> decoded = huffman_decode_symbols<uint16_t>(encodedBytes);
+    const double decodeSeconds = elapsed_seconds(start);
+
+    report_huffman_result("Symbols16", samples.size() * sizeof(uint16_t), encodedBytes.size(),
+                          encodeSeconds, decodeSeconds, decoded == samples);
+}
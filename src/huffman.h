@@ -10,11 +10,99 @@
 #include <azgra/io/text_file_functions.h>
 #include "entropy.h"
 
-void huffman_encode(azgra::io::stream::OutMemoryBitStream &stream,
-                    const huffman::HuffmanTree<azgra::StringView::value_type> &huffman,
-                    const azgra::StringView textToEncode);
+/**
+ * Encode text with canonical Huffman code.
+ * @param textToEncode Text to encode.
+ * @return Encoded bytes.
+ */
+azgra::ByteArray huffman_encode_canonical(const azgra::StringView textToEncode);
 
-std::string huffman_decode(azgra::io::stream::InMemoryBitStream &stream);
+/**
+ * Decode text encoded by huffman_encode_canonical, using the table driven decoder.
+ * @param encodedBytes Encoded bytes.
+ * @return Decoded text.
+ */
+std::string huffman_decode_canonical(const azgra::ByteArray &encodedBytes);
+
+/**
+ * Number of independent bit streams of the interleaved format.
+ */
+constexpr std::size_t HUFFMAN_INTERLEAVED_STREAM_COUNT = 4;
+
+/**
+ * Encode text with canonical Huffman code into interleaved streams, which share one code table.
+ * Text is split into HUFFMAN_INTERLEAVED_STREAM_COUNT segments, so that the decoder can advance all streams in one loop.
+ * @param textToEncode Text to encode.
+ * @return Encoded bytes.
+ */
+azgra::ByteArray huffman_encode_interleaved(const azgra::StringView textToEncode);
+
+/**
+ * Decode text encoded by huffman_encode_interleaved.
+ * @param encodedBytes Encoded bytes.
+ * @return Decoded text.
+ */
+std::string huffman_decode_interleaved(const azgra::ByteArray &encodedBytes);
+
+/**
+ * Default size of the block in the block-parallel format.
+ */
+constexpr std::size_t HUFFMAN_DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+/**
+ * Flags of the block table in the block-parallel format.
+ */
+constexpr azgra::byte HUFFMAN_BLOCK_OWN_TABLE = 0;
+constexpr azgra::byte HUFFMAN_BLOCK_PREVIOUS_TABLE = 1;
+
+/**
+ * Encode text in independent blocks. Every block gets its own code table, or reuses the table of the previous block
+ * if it is cheaper. Blocks are encoded in parallel, the header contains block index for the parallel decode.
+ * @param textToEncode Text to encode.
+ * @param blockSize Number of bytes in the block.
+ * @return Encoded bytes.
+ */
+azgra::ByteArray huffman_encode_blocks(const azgra::StringView textToEncode,
+                                       const std::size_t blockSize = HUFFMAN_DEFAULT_BLOCK_SIZE);
+
+/**
+ * Decode text encoded by huffman_encode_blocks. Blocks are decoded in parallel.
+ * @param encodedBytes Encoded bytes.
+ * @return Decoded text.
+ */
+std::string huffman_decode_blocks(const azgra::ByteArray &encodedBytes);
+
+/**
+ * Maximal number of code tables of the order-1 context coder.
+ */
+constexpr std::size_t HUFFMAN_CONTEXT_MAX_TABLES = 32;
+
+/**
+ * Encode text with order-1 context Huffman code. Every previous byte selects one of the code tables,
+ * contexts with similar statistics share the table, so that rare contexts don't cost the whole table in the header.
+ * @param textToEncode Text to encode.
+ * @return Encoded bytes.
+ */
+azgra::ByteArray huffman_encode_context(const azgra::StringView textToEncode);
+
+/**
+ * Decode text encoded by huffman_encode_context.
+ * @param encodedBytes Encoded bytes.
+ * @return Decoded text.
+ */
+std::string huffman_decode_context(const azgra::ByteArray &encodedBytes);
+
+/**
+ * Test the Huffman coders on the input file, report results.
+ * @param inputFile Input file.
+ */
+void test_huffman(const char *inputFile);
+
+/**
+ * Test the large alphabet coder on the file of 16 bit samples separated by whitespace, report results.
+ * @param inputFile Input file.
+ */
+void test_huffman_symbols(const char *inputFile);
 
 //void test_huffmann(azgra::BasicStringView<char> inputFile)
 //{
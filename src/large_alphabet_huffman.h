@@ -0,0 +1,119 @@
+#pragma once
+
+#include "generic_huffman.h"
+#include <limits>
+
+/**
+ * Largest alphabet of the large alphabet coder, symbols have to fit into the 16 bit decode entries.
+ */
+constexpr std::size_t HUFFMAN_LARGE_ALPHABET_MAX_SIZE = 1u << 16u;
+
+/**
+ * Code length limit of the large alphabet coder. Every code can be resolved by the two level decode table.
+ */
+constexpr azgra::byte HUFFMAN_LARGE_ALPHABET_CODE_LENGTH = 20;
+
+/**
+ * Number of bits of the first level decode table of the large alphabet coder.
+ */
+constexpr azgra::byte HUFFMAN_LARGE_ALPHABET_TABLE_BITS = 12;
+
+/**
+ * Number of bits of the single code length in the large alphabet header.
+ */
+constexpr azgra::byte HUFFMAN_LARGE_ALPHABET_HEADER_BITS = 5;
+
+static_assert(HUFFMAN_LARGE_ALPHABET_CODE_LENGTH <= huffman::HUFFMAN_MAX_TWO_LEVEL_CODE_LENGTH);
+static_assert(HUFFMAN_LARGE_ALPHABET_CODE_LENGTH < (1u << HUFFMAN_LARGE_ALPHABET_HEADER_BITS));
+
+/**
+ * Encode integer symbols with canonical Huffman code. Alphabet is formed by the values 0..max(symbols),
+ * so that the symbol table is indexed directly, unused values are skipped by the runs in the code lengths header.
+ * @tparam SymbolType Unsigned integral type of at most 16 bits.
+ * @param symbols Symbols to encode.
+ * @return Encoded bytes.
+ */
+template<typename SymbolType>
+azgra::ByteArray huffman_encode_symbols(const std::vector<SymbolType> &symbols)
+{
+    static_assert(std::is_integral_v<SymbolType> && std::is_unsigned_v<SymbolType>);
+    static_assert(sizeof(SymbolType) <= sizeof(uint16_t));
+
+    std::size_t alphabetSize = 0;
+    for (const SymbolType symbol : symbols)
+    {
+        alphabetSize = std::max<std::size_t>(alphabetSize, static_cast<std::size_t>(symbol) + 1);
+    }
+
+    std::vector<std::size_t> histogram(alphabetSize, 0);
+    for (const SymbolType symbol : symbols)
+    {
+        ++histogram[symbol];
+    }
+
+    const auto codeLengths = huffman::build_code_lengths(histogram, HUFFMAN_LARGE_ALPHABET_CODE_LENGTH);
+    const huffman::CanonicalHuffmanCode canonicalCode = huffman::create_canonical_code(codeLengths);
+
+    std::size_t payloadBits = 0;
+    for (std::size_t symbol = 0; symbol < alphabetSize; ++symbol)
+    {
+        payloadBits += histogram[symbol] * codeLengths[symbol];
+    }
+    const std::size_t headerBits = huffman::code_lengths_header_bits(codeLengths, HUFFMAN_LARGE_ALPHABET_HEADER_BITS);
+
+    OutWordBitStream stream(sizeof(uint64_t) + sizeof(uint32_t) + ((headerBits + payloadBits + 7) / 8));
+    stream.write_value(static_cast<uint64_t>(symbols.size()));
+    stream.write_value(static_cast<uint32_t>(alphabetSize));
+    huffman::write_code_lengths(stream, codeLengths, HUFFMAN_LARGE_ALPHABET_HEADER_BITS);
+
+    const huffman::HuffmanCode *codes = canonicalCode.codes.data();
+    for (const SymbolType symbol : symbols)
+    {
+        const huffman::HuffmanCode &code = codes[symbol];
+        stream.write_bits(code.bits, code.length);
+    }
+    return stream.get_flushed_buffer();
+}
+
+/**
+ * Decode symbols encoded by huffman_encode_symbols.
+ * @tparam SymbolType Unsigned integral type of at most 16 bits, same as used by the encoder.
+ * @param encodedBytes Encoded bytes.
+ * @return Decoded symbols.
+ */
+template<typename SymbolType>
+std::vector<SymbolType> huffman_decode_symbols(const azgra::ByteArray &encodedBytes)
+{
+    static_assert(std::is_integral_v<SymbolType> && std::is_unsigned_v<SymbolType>);
+    static_assert(sizeof(SymbolType) <= sizeof(uint16_t));
+
+    InWordBitStream stream(encodedBytes.data(), encodedBytes.size());
+    const auto expectedSymbolCount = stream.read_value<uint64_t>();
+    const auto alphabetSize = stream.read_value<uint32_t>();
+    always_assert(alphabetSize <= (static_cast<std::size_t>(std::numeric_limits<SymbolType>::max()) + 1) &&
+                  "Alphabet doesn't fit into the symbol type.");
+
+    std::vector<SymbolType> symbols(expectedSymbolCount);
+    if (expectedSymbolCount == 0)
+        return symbols;
+
+    const auto codeLengths = huffman::read_code_lengths(stream, alphabetSize, HUFFMAN_LARGE_ALPHABET_HEADER_BITS);
+    const huffman::HuffmanDecodeTable table = huffman::create_decode_table(codeLengths, HUFFMAN_LARGE_ALPHABET_TABLE_BITS);
+
+    const std::size_t symbolsPerRefill = huffman::symbols_per_refill(table);
+    std::size_t i = 0;
+    while (i + symbolsPerRefill <= expectedSymbolCount)
+    {
+        stream.refill();
+        for (std::size_t s = 0; s < symbolsPerRefill; ++s)
+        {
+            symbols[i++] = static_cast<SymbolType>(huffman::decode_symbol(table, stream));
+        }
+    }
+    for (; i < expectedSymbolCount; ++i)
+    {
+        stream.refill();
+        symbols[i] = static_cast<SymbolType>(huffman::decode_symbol(table, stream));
+    }
+    return symbols;
+}
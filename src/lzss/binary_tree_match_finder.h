@@ -0,0 +1,258 @@
+#pragma once
+
+#include <azgra/azgra.h>
+#include <azgra/always_on_assert.h>
+#include <vector>
+#include <limits>
+#include "lz_match.h"
+#include "lz_compare.h"
+#include "hash_chain_match_finder.h"
+
+/**
+ * Number of bits of the binary tree root table.
+ */
+constexpr azgra::byte LZ_BINARY_TREE_HASH_BITS = 16;
+
+/**
+ * Default number of tree nodes visited for every position.
+ */
+constexpr std::size_t LZ_DEFAULT_TREE_DEPTH = 32;
+
+/**
+ * Match finder, which keeps binary search tree of the window positions for every hash of the first bytes.
+ * Tree links are stored in the cyclic array over the window. Every position is inserted as the new root of its tree
+ * in the same walk, which finds its matches, so the tree is traversed only once per position.
+ */
+class BinaryTreeMatchFinder
+{
+private:
+    /**
+     * Position value of empty root or missing child.
+     */
+    static constexpr uint32_t EMPTY_POSITION = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Data being compressed.
+     */
+    const azgra::byte *m_data{nullptr};
+
+    /**
+     * Number of bytes of the data.
+     */
+    std::size_t m_size{0};
+
+    /**
+     * Largest distance of the match.
+     */
+    std::size_t m_maxDistance{0};
+
+    /**
+     * Largest length of the match.
+     */
+    std::size_t m_maxMatchLength{0};
+
+    /**
+     * Largest number of nodes visited for single position.
+     */
+    std::size_t m_maxDepth{0};
+
+    /**
+     * Length of the match, which is good enough to stop the search.
+     */
+    std::size_t m_goodMatchLength{0};
+
+    /**
+     * Root position of every hash tree.
+     */
+    std::vector<uint32_t> m_head;
+
+    /**
+     * Lesser and greater child of every window position, pair index is (position % m_cyclicSize).
+     */
+    std::vector<uint32_t> m_children;
+
+    /**
+     * Number of positions in the cyclic child array.
+     */
+    std::size_t m_cyclicSize{0};
+
+    /**
+     * Cyclic index of the next inserted position.
+     */
+    std::size_t m_cyclicPosition{0};
+
+    /**
+     * First position, which wasn't inserted yet.
+     */
+    std::size_t m_nextPosition{0};
+
+    /**
+     * Matches of the last position.
+     */
+    std::vector<LzMatch> m_matches;
+
+    static inline std::size_t hash(const azgra::byte *bytes)
+    {
+        const uint32_t value = static_cast<uint32_t>(bytes[0]) |
+                               (static_cast<uint32_t>(bytes[1]) << 8u) |
+                               (static_cast<uint32_t>(bytes[2]) << 16u);
+        return (value * 2654435761u) >> (32u - LZ_BINARY_TREE_HASH_BITS);
+    }
+
+    /**
+     * Insert the position as the root of its tree. Visited nodes are split into lesser and greater subtrees
+     * of the new root, reported matches are strictly longer than the previous ones.
+     * @tparam CollectMatches True if found matches are appended to the matches.
+     * @param position Inserted position.
+     * @param matches Matches of the position.
+     */
+    template<bool CollectMatches>
+    void insert_position(const std::size_t position, std::vector<LzMatch> &matches)
+    {
+        const std::size_t cyclicPosition = m_cyclicPosition;
+        if (++m_cyclicPosition == m_cyclicSize)
+        {
+            m_cyclicPosition = 0;
+        }
+
+        const std::size_t lengthLimit = std::min(m_maxMatchLength, m_size - position);
+        if (lengthLimit < LZ_HASH_CHAIN_MIN_MATCH)
+            return;
+
+        const azgra::byte *current = m_data + position;
+        uint32_t &head = m_head[hash(current)];
+        uint32_t candidate = head;
+        head = static_cast<uint32_t>(position);
+
+        // Slots waiting for the next lesser and greater node of the new root.
+        uint32_t *lesserSlot = &m_children[cyclicPosition * 2];
+        uint32_t *greaterSlot = &m_children[cyclicPosition * 2 + 1];
+        // Known common prefix of the current data with every node in the lesser and greater subtree.
+        std::size_t lesserLength = 0;
+        std::size_t greaterLength = 0;
+        std::size_t bestLength = LZ_HASH_CHAIN_MIN_MATCH - 1;
+        std::size_t depth = m_maxDepth;
+
+        while (true)
+        {
+            const std::size_t distance = position - candidate;
+            if ((candidate == EMPTY_POSITION) || (distance > m_maxDistance) || (depth-- == 0))
+            {
+                *lesserSlot = EMPTY_POSITION;
+                *greaterSlot = EMPTY_POSITION;
+                return;
+            }
+
+            const std::size_t candidateCyclic = (distance <= cyclicPosition)
+                                                ? (cyclicPosition - distance)
+                                                : (cyclicPosition + m_cyclicSize - distance);
+            uint32_t *candidateChildren = &m_children[candidateCyclic * 2];
+            const azgra::byte *match = current - distance;
+
+            std::size_t length = std::min(lesserLength, greaterLength);
+            if (match[length] == current[length])
+            {
+                ++length;
+                length += lz_match_length(match + length, current + length, lengthLimit - length);
+
+                if (CollectMatches && (length > bestLength))
+                {
+                    bestLength = length;
+                    matches.emplace_back(distance, length);
+                }
+                if (length == lengthLimit)
+                {
+                    // NOTE(Moravec): Candidate is equal to the current data, the new root takes over its children.
+                    *lesserSlot = candidateChildren[0];
+                    *greaterSlot = candidateChildren[1];
+                    return;
+                }
+                if (length >= m_goodMatchLength)
+                {
+                    // Candidate is still linked below, the walk ends in the next step.
+                    depth = 0;
+                }
+            }
+
+            if (match[length] < current[length])
+            {
+                *lesserSlot = candidate;
+                lesserSlot = &candidateChildren[1];
+                candidate = *lesserSlot;
+                lesserLength = length;
+            }
+            else
+            {
+                *greaterSlot = candidate;
+                greaterSlot = &candidateChildren[0];
+                candidate = *greaterSlot;
+                greaterLength = length;
+            }
+        }
+    }
+
+    /**
+     * Insert all positions before the position into the trees.
+     * @param position First position, which won't be inserted.
+     */
+    inline void insert_until(const std::size_t position)
+    {
+        for (; m_nextPosition < position; ++m_nextPosition)
+        {
+            insert_position<false>(m_nextPosition, m_matches);
+        }
+    }
+
+public:
+    /**
+     * Create the match finder over the data.
+     * @param data Data being compressed.
+     * @param size Number of bytes of the data.
+     * @param maxDistance Largest distance of the match, the search buffer size.
+     * @param maxMatchLength Largest length of the match, the look-ahead buffer size.
+     * @param maxDepth Largest number of nodes visited for single position.
+     * @param goodMatchLength Length of the match, which is good enough to stop the search.
+     */
+    explicit BinaryTreeMatchFinder(const azgra::byte *data,
+                                   const std::size_t size,
+                                   const std::size_t maxDistance,
+                                   const std::size_t maxMatchLength,
+                                   const std::size_t maxDepth = LZ_DEFAULT_TREE_DEPTH,
+                                   const std::size_t goodMatchLength = std::numeric_limits<std::size_t>::max())
+            : m_data(data), m_size(size), m_maxDistance(maxDistance), m_maxMatchLength(maxMatchLength),
+              m_maxDepth(maxDepth), m_goodMatchLength(goodMatchLength)
+    {
+        always_assert(size < EMPTY_POSITION && "Binary tree positions are 32 bit.");
+        m_cyclicSize = maxDistance + 1;
+        m_head.resize(static_cast<std::size_t>(1) << LZ_BINARY_TREE_HASH_BITS, EMPTY_POSITION);
+        m_children.resize(m_cyclicSize * 2, EMPTY_POSITION);
+        m_matches.reserve(maxMatchLength);
+    }
+
+    /**
+     * Find all matches for the position and insert it into the tree. Skipped positions are inserted first.
+     * @param position Position in the data, positions have to be increasing.
+     * @param matches Found matches ordered by increasing length and distance, every match is longer than the previous.
+     * @return Number of found matches.
+     */
+    std::size_t find_matches(const std::size_t position, std::vector<LzMatch> &matches)
+    {
+        insert_until(position);
+        matches.clear();
+        insert_position<true>(position, matches);
+        m_nextPosition = position + 1;
+        return matches.size();
+    }
+
+    /**
+     * Find the longest match for the position and insert it into the tree.
+     * @param position Position in the data, positions have to be increasing.
+     * @return The longest match, zero length if there is none.
+     */
+    LzMatch find_best_match(const std::size_t position)
+    {
+        if (find_matches(position, m_matches) == 0)
+            return LzMatch();
+        return m_matches.back();
+    }
+};
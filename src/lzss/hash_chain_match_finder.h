@@ -0,0 +1,186 @@
+#pragma once
+
+#include <azgra/azgra.h>
+#include <azgra/always_on_assert.h>
+#include <vector>
+#include <limits>
+#include "lz_match.h"
+#include "lz_compare.h"
+
+/**
+ * Number of bits of the hash head table.
+ */
+constexpr azgra::byte LZ_HASH_CHAIN_HASH_BITS = 16;
+
+/**
+ * Number of bytes hashed to find the chain, shorter matches can't be found by the hash chain.
+ */
+constexpr std::size_t LZ_HASH_CHAIN_MIN_MATCH = 3;
+
+/**
+ * Default number of chain candidates checked for every position.
+ */
+constexpr std::size_t LZ_DEFAULT_CHAIN_LENGTH = 64;
+
+/**
+ * Match finder, which hashes the first bytes of every position into the head table and links positions
+ * with the same hash by the prev chain. Prev chain is circular over the window, so its memory is O(window).
+ */
+class HashChainMatchFinder
+{
+private:
+    /**
+     * Position value of empty head or chain end.
+     */
+    static constexpr uint32_t EMPTY_POSITION = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Data being compressed.
+     */
+    const azgra::byte *m_data{nullptr};
+
+    /**
+     * Number of bytes of the data.
+     */
+    std::size_t m_size{0};
+
+    /**
+     * Largest distance of the match.
+     */
+    std::size_t m_maxDistance{0};
+
+    /**
+     * Largest length of the match.
+     */
+    std::size_t m_maxMatchLength{0};
+
+    /**
+     * Largest number of candidates checked for single position.
+     */
+    std::size_t m_maxChainLength{0};
+
+    /**
+     * Length of the match, which is good enough to stop the search.
+     */
+    std::size_t m_goodMatchLength{0};
+
+    /**
+     * Last inserted position of every hash.
+     */
+    std::vector<uint32_t> m_head;
+
+    /**
+     * Previous position with the same hash, indexed by (position & m_windowMask).
+     */
+    std::vector<uint32_t> m_prev;
+
+    /**
+     * Mask of the circular prev chain, the chain is larger than the largest distance.
+     */
+    std::size_t m_windowMask{0};
+
+    /**
+     * First position, which wasn't inserted yet.
+     */
+    std::size_t m_nextPosition{0};
+
+    static inline std::size_t hash(const azgra::byte *bytes)
+    {
+        const uint32_t value = static_cast<uint32_t>(bytes[0]) |
+                               (static_cast<uint32_t>(bytes[1]) << 8u) |
+                               (static_cast<uint32_t>(bytes[2]) << 16u);
+        return (value * 2654435761u) >> (32u - LZ_HASH_CHAIN_HASH_BITS);
+    }
+
+    /**
+     * Insert all positions before the position into the chains.
+     * @param position First position, which won't be inserted.
+     */
+    inline void insert_until(const std::size_t position)
+    {
+        const std::size_t insertEnd = std::min(position, (m_size >= LZ_HASH_CHAIN_MIN_MATCH) ? (m_size - LZ_HASH_CHAIN_MIN_MATCH + 1) : 0);
+        for (; m_nextPosition < insertEnd; ++m_nextPosition)
+        {
+            uint32_t &head = m_head[hash(m_data + m_nextPosition)];
+            m_prev[m_nextPosition & m_windowMask] = head;
+            head = static_cast<uint32_t>(m_nextPosition);
+        }
+        m_nextPosition = std::max(m_nextPosition, position);
+    }
+
+public:
+    /**
+     * Create the match finder over the data.
+     * @param data Data being compressed.
+     * @param size Number of bytes of the data.
+     * @param maxDistance Largest distance of the match, the search buffer size.
+     * @param maxMatchLength Largest length of the match, the look-ahead buffer size.
+     * @param maxChainLength Largest number of candidates checked for single position.
+     * @param goodMatchLength Length of the match, which is good enough to stop the search.
+     */
+    explicit HashChainMatchFinder(const azgra::byte *data,
+                                  const std::size_t size,
+                                  const std::size_t maxDistance,
+                                  const std::size_t maxMatchLength,
+                                  const std::size_t maxChainLength = LZ_DEFAULT_CHAIN_LENGTH,
+                                  const std::size_t goodMatchLength = std::numeric_limits<std::size_t>::max())
+            : m_data(data), m_size(size), m_maxDistance(maxDistance), m_maxMatchLength(maxMatchLength),
+              m_maxChainLength(maxChainLength), m_goodMatchLength(goodMatchLength)
+    {
+        always_assert(size < EMPTY_POSITION && "Hash chain positions are 32 bit.");
+        std::size_t windowSize = 1;
+        while (windowSize <= maxDistance)
+        {
+            windowSize <<= 1u;
+        }
+        m_windowMask = windowSize - 1;
+        m_head.resize(static_cast<std::size_t>(1) << LZ_HASH_CHAIN_HASH_BITS, EMPTY_POSITION);
+        m_prev.resize(windowSize, EMPTY_POSITION);
+    }
+
+    /**
+     * Find the longest match for the position. All previous positions are inserted into the chains first,
+     * the position itself is inserted by the next call.
+     * @param position Position in the data, positions have to be non-decreasing.
+     * @return The longest match, zero length if there is none.
+     */
+    LzMatch find_best_match(const std::size_t position)
+    {
+        insert_until(position);
+
+        LzMatch bestMatch;
+        const std::size_t maxLength = std::min(m_maxMatchLength, m_size - position);
+        if (maxLength < LZ_HASH_CHAIN_MIN_MATCH)
+            return bestMatch;
+
+        const azgra::byte *current = m_data + position;
+        uint32_t candidate = m_head[hash(current)];
+        std::size_t chainLength = m_maxChainLength;
+        while ((candidate != EMPTY_POSITION) && (chainLength-- > 0))
+        {
+            const std::size_t distance = position - candidate;
+            if (distance > m_maxDistance)
+                break;
+
+            const azgra::byte *match = m_data + candidate;
+            // NOTE(Moravec): Only candidates, which can be longer than the best match, are compared whole.
+            if (match[bestMatch.length] == current[bestMatch.length])
+            {
+                const std::size_t length = lz_match_length(match, current, maxLength);
+                if (length > bestMatch.length)
+                {
+                    bestMatch = LzMatch(distance, length);
+                    if ((length == maxLength) || (length >= m_goodMatchLength))
+                        break;
+                }
+            }
+
+            const uint32_t previous = m_prev[candidate & m_windowMask];
+            // Older chain entries were overwritten by newer positions, the chain would continue forward.
+            if ((previous == EMPTY_POSITION) || (previous >= candidate))
+                break;
+            candidate = previous;
+        }
+        return bestMatch;
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <azgra/azgra.h>
+#include <cstring>
+#include <algorithm>
+
+/**
+ * Number of bytes compared at once by the match kernels.
+ */
+constexpr std::size_t LZ_COMPARE_WORD_SIZE = sizeof(uint64_t);
+
+/**
+ * Load unaligned word from the bytes.
+ * @param bytes Bytes of the word.
+ * @return Word in the native byte order.
+ */
+inline uint64_t lz_load_word(const azgra::byte *bytes)
+{
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+/**
+ * Get index of the first different byte in the non-zero XOR of two words.
+ * @param difference XOR of the words loaded by lz_load_word.
+ * @return Index of the first different byte in the memory order.
+ */
+inline std::size_t lz_first_different_byte(const uint64_t difference)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return static_cast<std::size_t>(__builtin_ctzll(difference)) >> 3u;
+#else
+    return static_cast<std::size_t>(__builtin_clzll(difference)) >> 3u;
+#endif
+}
+
+/**
+ * Find the length of the common prefix of two byte strings. Strings are compared word at a time,
+ * the rest shorter than the word is compared byte by byte. Only the first limit bytes are read.
+ * @param a First string.
+ * @param b Second string.
+ * @param limit Largest length of the match.
+ * @return Length of the common prefix.
+ */
+inline std::size_t lz_match_length(const azgra::byte *a, const azgra::byte *b, const std::size_t limit)
+{
+    std::size_t length = 0;
+    for (; (length + LZ_COMPARE_WORD_SIZE) <= limit; length += LZ_COMPARE_WORD_SIZE)
+    {
+        const uint64_t difference = lz_load_word(a + length) ^ lz_load_word(b + length);
+        if (difference != 0)
+        {
+            return length + lz_first_different_byte(difference);
+        }
+    }
+    while ((length < limit) && (a[length] == b[length]))
+    {
+        ++length;
+    }
+    return length;
+}
+
+/**
+ * Lexicographic compare of two strings with the known common prefix length.
+ * @param a First string.
+ * @param aSize Size of the first string.
+ * @param b Second string.
+ * @param bSize Size of the second string.
+ * @param matchLength Common prefix length, as returned by lz_match_length for the shorter size.
+ * @return Negative if a is smaller, positive if a is greater and zero for equal strings.
+ */
+inline int lz_compare_after_match(const azgra::byte *a, const std::size_t aSize,
+                                  const azgra::byte *b, const std::size_t bSize,
+                                  const std::size_t matchLength)
+{
+    if (matchLength < std::min(aSize, bSize))
+    {
+        return (a[matchLength] < b[matchLength]) ? -1 : 1;
+    }
+    return (aSize < bSize) ? -1 : ((aSize > bSize) ? 1 : 0);
+}
+
+/**
+ * Lexicographic compare of two strings, the shorter prefix is smaller.
+ * @param a First string.
+ * @param aSize Size of the first string.
+ * @param b Second string.
+ * @param bSize Size of the second string.
+ * @return Negative if a is smaller, positive if a is greater and zero for equal strings.
+ */
+inline int lz_lexicographic_compare(const azgra::byte *a, const std::size_t aSize,
+                                    const azgra::byte *b, const std::size_t bSize)
+{
+    return lz_compare_after_match(a, aSize, b, bSize, lz_match_length(a, b, std::min(aSize, bSize)));
+}
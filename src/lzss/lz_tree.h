@@ -1,9 +1,15 @@
 #pragma once
 
+#include <vector>
+#include <type_traits>
+#include <azgra/always_on_assert.h>
 #include "lz_node.h"
+#include "lz_compare.h"
 
 /**
  * LZSS Binary Search tree.
+ * Nodes are stored in the pool indexed by (position % capacity), so the tree never allocates after construction.
+ * Capacity has to be larger than the range of positions, which are in the tree at once.
  * @tparam T Type of the node data.
  */
 template<typename T>
@@ -11,125 +17,296 @@ class LzTree
 {
 private:
     /**
-     * Tree root node.
+     * Data of all the nodes.
      */
-    std::unique_ptr<LzNode<T>> m_root;
+    const T *m_data{nullptr};
+
+    /**
+     * Size of the node data span.
+     */
+    std::size_t m_spanSize{0};
+
+    /**
+     * Node pool.
+     */
+    std::vector<LzNode> m_nodes;
+
+    /**
+     * Index of the tree root node.
+     */
+    uint32_t m_root{LZ_NIL_NODE};
 
     /**
      * Node count in the tree.
      */
     std::size_t m_nodeCount{0};
 
-public:
+    [[nodiscard]] inline azgra::Span<T> node_data(const uint32_t nodeIndex) const
+    {
+        return azgra::Span<T>(m_data + m_nodes[nodeIndex].position, m_spanSize);
+    }
+
+    [[nodiscard]] inline uint32_t node_index(const azgra::Span<T> &nodeData) const
+    {
+        return static_cast<uint32_t>(static_cast<std::size_t>(nodeData.data() - m_data) % m_nodes.size());
+    }
+
     /**
-     * Default constructor. Tree without root.
+     * Byte data are compared by the word at a time kernels.
      */
-    LzTree() = default;
+    static constexpr bool USE_BYTE_KERNELS = std::is_same_v<T, azgra::byte>;
+
+    [[nodiscard]] static inline std::size_t match_length(const azgra::Span<T> &a, const azgra::Span<T> &b)
+    {
+        if constexpr (USE_BYTE_KERNELS)
+        {
+            return lz_match_length(a.data(), b.data(), std::min(a.size(), b.size()));
+        }
+        else
+        {
+            return a.match_length(b);
+        }
+    }
+
+    [[nodiscard]] static inline int compare(const azgra::Span<T> &a, const azgra::Span<T> &b)
+    {
+        if constexpr (USE_BYTE_KERNELS)
+        {
+            return lz_lexicographic_compare(a.data(), a.size(), b.data(), b.size());
+        }
+        else
+        {
+            return a.lexicographic_compare(b);
+        }
+    }
 
     /**
-     * Create the tree with the root.
-     * @param rootNode The root node.
+     * Find node by its data.
+     * @param targetData Target node data.
+     * @return Index of the node or LZ_NIL_NODE.
      */
-    explicit LzTree(std::unique_ptr<LzNode<T>> &&rootNode)
+    [[nodiscard]] uint32_t find_node_by_data(const azgra::Span<T> &targetData) const
     {
-        m_root = std::move(rootNode);
-        m_nodeCount = 1;
+        uint32_t nodeIndex = m_root;
+        while (nodeIndex != LZ_NIL_NODE)
+        {
+            const int comparison = compare(targetData, node_data(nodeIndex));
+            if (comparison == 0)
+                return nodeIndex;
+            nodeIndex = (comparison < 0) ? m_nodes[nodeIndex].lesser : m_nodes[nodeIndex].greater;
+        }
+        return LZ_NIL_NODE;
     }
 
     /**
-     * Find best match for the targetData.
-     * @param targetData Data to find match for.
-     * @return Best match for the data.
+     * Put the other node (or nothing) to the place of the node in its parent.
+     * @param nodeIndex Replaced node.
+     * @param replacementIndex Replacement node or LZ_NIL_NODE.
      */
-    [[nodiscard]] LzMatch find_best_match(const azgra::Span<T> &targetData) const
+    void replace_in_parent(const uint32_t nodeIndex, const uint32_t replacementIndex)
     {
-        if (!m_root)
-        { return LzMatch(); }
+        const uint32_t parentIndex = m_nodes[nodeIndex].parent;
+        if (parentIndex == LZ_NIL_NODE)
+        {
+            m_root = replacementIndex;
+        }
+        else if (m_nodes[parentIndex].lesser == nodeIndex)
+        {
+            m_nodes[parentIndex].lesser = replacementIndex;
+        }
+        else
+        {
+            m_nodes[parentIndex].greater = replacementIndex;
+        }
 
-        LzMatch match{};
-        m_root->find_best_match(targetData, match);
-        return match;
+        if (replacementIndex != LZ_NIL_NODE)
+        {
+            m_nodes[replacementIndex].parent = parentIndex;
+        }
     }
 
     /**
-     * Delete node from the tree, based on its data.
-     * @param dataToDelete Node to be deleted data.
-     * @return Deletion result
+     * Move the other node to the place of the node in the tree, including its children.
+     * @param nodeIndex Replaced node.
+     * @param replacementIndex Replacement node.
      */
-    NodeDeletionResult delete_node(const azgra::Span<T> &dataToDelete)
+    void replace_node(const uint32_t nodeIndex, const uint32_t replacementIndex)
     {
-        if (!m_root)
-        { return NodeDeletionResult::NodeNotFound; }
+        replace_in_parent(nodeIndex, replacementIndex);
+        LzNode &replacement = m_nodes[replacementIndex];
+        replacement.lesser = m_nodes[nodeIndex].lesser;
+        replacement.greater = m_nodes[nodeIndex].greater;
+        if (replacement.lesser != LZ_NIL_NODE)
+        {
+            m_nodes[replacement.lesser].parent = replacementIndex;
+        }
+        if (replacement.greater != LZ_NIL_NODE)
+        {
+            m_nodes[replacement.greater].parent = replacementIndex;
+        }
+    }
 
-        NodeDeletionResult deletionResult = NodeDeletionResult::UnknownError;
-        // Deleting root node.
-        if (m_root->m_data == dataToDelete)
+    /**
+     * Unlink the node from the tree.
+     * @param nodeIndex Node to unlink.
+     */
+    void remove_node(const uint32_t nodeIndex)
+    {
+        const LzNode &node = m_nodes[nodeIndex];
+        if ((node.lesser != LZ_NIL_NODE) && (node.greater != LZ_NIL_NODE))
         {
-            if (--m_root->m_lives >= 1)
+            // Inorder successor (the smallest greater node) takes the place of the node.
+            uint32_t successorIndex = node.greater;
+            while (m_nodes[successorIndex].lesser != LZ_NIL_NODE)
             {
-                // NOTE(Moravec): Node still have one or more lives. Node won't be deleted
-                return NodeDeletionResult::NodeSurvived;
+                successorIndex = m_nodes[successorIndex].lesser;
             }
+            replace_in_parent(successorIndex, m_nodes[successorIndex].greater);
+            replace_node(nodeIndex, successorIndex);
+        }
+        else
+        {
+            replace_in_parent(nodeIndex, (node.lesser != LZ_NIL_NODE) ? node.lesser : node.greater);
+        }
+    }
 
-            if (m_root->m_lesser && !m_root->m_greater)
-            {
-                auto lesserNode = std::move(m_root->m_lesser);
-                m_root.release();
-                m_root = std::move(lesserNode);
-                m_root->m_parent = nullptr;
+public:
+    /**
+     * Default constructor. Tree without data.
+     */
+    LzTree() = default;
+
+    /**
+     * Create empty tree over the data.
+     * @param data Data of all the nodes, node data are spans of this data.
+     * @param size Number of elements of the data.
+     * @param capacity Size of the node pool, larger than the range of positions in the tree at once.
+     */
+    explicit LzTree(const T *data, const std::size_t size, const std::size_t capacity) : m_data(data)
+    {
+        always_assert(size < LZ_NIL_NODE && "Tree node positions are 32 bit.");
+        always_assert(capacity > 0 && capacity < LZ_NIL_NODE);
+        m_nodes.resize(capacity);
+    }
 
-                deletionResult = NodeDeletionResult::NodeDeleted;
+    /**
+     * Find best match for the targetData.
+     * @param targetData Data to find match for.
+     * @return Best match for the data.
+     */
+    [[nodiscard]] LzMatch find_best_match(const azgra::Span<T> &targetData) const
+    {
+        LzMatch match{};
+        uint32_t nodeIndex = m_root;
+        while (nodeIndex != LZ_NIL_NODE)
+        {
+            const azgra::Span<T> nodeData = node_data(nodeIndex);
+            int comparison;
+            if (nodeData[0] == targetData[0])
+            {
+                const std::size_t matchLength = match_length(nodeData, targetData);
+                if (matchLength > match.length)
+                {
+                    match.distance = targetData.data() - nodeData.data();
+                    match.length = matchLength;
+                }
+                if constexpr (USE_BYTE_KERNELS)
+                {
+                    // NOTE(Moravec): Common prefix is already known, the compare needs only the next byte.
+                    comparison = lz_compare_after_match(targetData.data(), targetData.size(),
+                                                        nodeData.data(), nodeData.size(), matchLength);
+                }
+                else
+                {
+                    comparison = compare(targetData, nodeData);
+                }
             }
-            else if (m_root->m_greater && !m_root->m_lesser)
+            else
             {
-                auto greaterNode = std::move(m_root->m_greater);
-                m_root.release();
-                m_root = std::move(greaterNode);
-                m_root->m_parent = nullptr;
+                comparison = (targetData[0] < nodeData[0]) ? -1 : 1;
+            }
 
-                deletionResult = NodeDeletionResult::NodeDeleted;
+            if (comparison < 0) // Target data are smaller.
+            {
+                nodeIndex = m_nodes[nodeIndex].lesser;
+            }
+            else if (comparison > 0) // Target data are greater.
+            {
+                nodeIndex = m_nodes[nodeIndex].greater;
             }
             else
             {
-                LzNode<T> *successor = m_root->find_inorder_successor();
-                const auto successorSpan = successor->m_data;
-                const auto successorLives = successor->m_lives;
-
-                const NodeDeletionResult deletedSuccessorNode = m_root->delete_node(successorSpan, true);
-                deletionResult = deletedSuccessorNode;
-
-                m_root->m_data = successorSpan;
-                m_root->m_lives = successorLives;
+                break;
             }
         }
-        else
+        return match;
+    }
+
+    /**
+     * Delete node from the tree, based on its data.
+     * @param dataToDelete Node to be deleted data.
+     * @return Deletion result
+     */
+    NodeDeletionResult delete_node(const azgra::Span<T> &dataToDelete)
+    {
+        const uint32_t nodeIndex = find_node_by_data(dataToDelete);
+        if (nodeIndex == LZ_NIL_NODE)
         {
-            deletionResult = m_root->delete_node(dataToDelete);
+            always_assert(false && "Didn't find node to delete.");
+            return NodeDeletionResult::NodeNotFound;
         }
 
-        if (deletionResult == NodeDeletionResult::NodeDeleted)
+        if (--m_nodes[nodeIndex].lives >= 1)
         {
-            --m_nodeCount;
+            // NOTE(Moravec): Node still have one or more lives. Node won't be deleted
+            return NodeDeletionResult::NodeSurvived;
         }
-        return deletionResult;
+
+        remove_node(nodeIndex);
+        --m_nodeCount;
+        return NodeDeletionResult::NodeDeleted;
     }
 
     /**
      * Add new node to the tree.
-     * @param nodeData New node data.
+     * @param nodeData New node data, all nodes have the same data size.
      */
     void add_node(azgra::Span<T> &&nodeData)
     {
-        if (!m_root)
+        m_spanSize = nodeData.size();
+        const uint32_t newIndex = node_index(nodeData);
+        m_nodes[newIndex] = LzNode(static_cast<uint32_t>(nodeData.data() - m_data));
+        ++m_nodeCount;
+
+        if (m_root == LZ_NIL_NODE)
         {
-            m_root = std::make_unique<LzNode<T>>(std::move(nodeData));
+            m_root = newIndex;
+            return;
         }
-        else
+
+        uint32_t nodeIndex = m_root;
+        while (true)
         {
+            LzNode &node = m_nodes[nodeIndex];
+            // Compare new node data to this node data.
+            const int comparison = compare(nodeData, node_data(nodeIndex));
+            if (comparison == 0)
+            {
+                // NOTE(Moravec): Data is duplicate, the newer position takes place of the node with its lives.
+                m_nodes[newIndex].lives = node.lives + 1;
+                replace_node(nodeIndex, newIndex);
+                return;
+            }
 
-            m_root->add_child(std::move(nodeData));
+            uint32_t &child = (comparison < 0) ? node.lesser : node.greater;
+            if (child == LZ_NIL_NODE)
+            {
+                child = newIndex;
+                m_nodes[newIndex].parent = nodeIndex;
+                return;
+            }
+            nodeIndex = child;
         }
-        ++m_nodeCount;
     }
 
     /**
@@ -139,12 +316,20 @@ public:
      */
     [[nodiscard]] bool contains_node(const azgra::Span<T> &targetData)
     {
-        return m_root->has_node_with_data(targetData);
+        return find_node_by_data(targetData) != LZ_NIL_NODE;
     }
 
+    /**
+     * Get number of the node positions in the tree.
+     * @return Node count.
+     */
+    [[nodiscard]] std::size_t node_count() const
+    {
+        return m_nodeCount;
+    }
 };
 
 /**
  * Typedef for memory tree.
  */
-typedef LzTree<azgra::byte> ByteLzTree;
\ No newline at end of file
+typedef LzTree<azgra::byte> ByteLzTree;
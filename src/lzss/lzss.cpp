@@ -1,29 +1,848 @@
 #include <azgra/fs/file_info.h>
+#include <cstring>
 #include "lzss.h"
+#include "lzss_stream.h"
+#include "../generic_huffman.h"
 
-void write_tokens_to_stream(azgra::io::stream::OutMemoryBitStream &encoderStream,
-                            const std::array<LzssToken, FLAG_GROUP_SIZE> &tokens,
-                            const azgra::byte SBits,
-                            const azgra::byte LBits,
-                            const azgra::byte flagIndex)
+/**
+ * Get slot of the length or distance value. Values below 4 have their own slots, larger values share the slot
+ * with the values of the same two highest bits and the remaining bits are written as extra bits.
+ * @param value Coded value.
+ * @return Slot of the value.
+ */
+static inline std::size_t value_slot(const std::size_t value)
 {
-    for (int fId = 0; fId < flagIndex; ++fId)
+    if (value < 4)
+        return value;
+    const auto highestBit = static_cast<std::size_t>(63 - __builtin_clzll(value));
+    return (2 * highestBit) + ((value >> (highestBit - 1)) & 1u);
+}
+
+/**
+ * Get number of extra bits of the slot.
+ * @param slot Value slot.
+ * @return Number of extra bits.
+ */
+static inline azgra::byte slot_extra_bits(const std::size_t slot)
+{
+    return (slot < 4) ? 0 : static_cast<azgra::byte>((slot / 2) - 1);
+}
+
+/**
+ * Get the smallest value of the slot.
+ * @param slot Value slot.
+ * @return Value without the extra bits.
+ */
+static inline std::size_t slot_base(const std::size_t slot)
+{
+    return (slot < 4) ? slot : ((2 | (slot & 1u)) << slot_extra_bits(slot));
+}
+
+/**
+ * Get number of slots of the values with the given number of bits.
+ * @param bits Number of bits of the value.
+ * @return Slot count.
+ */
+static inline std::size_t value_slot_count(const azgra::byte bits)
+{
+    return std::max<std::size_t>(4, 2 * static_cast<std::size_t>(bits));
+}
+
+/**
+ * Encoded size of the tokens in bits, used by the optimal parser. Fixed width formats have the flat prices including
+ * the flag bit. Huffman coded format prices the literals, length slots and distance slots by the code lengths
+ * of the token statistics, slot extra bits are added to the slot price.
+ */
+class LzssTokenPrices
+{
+private:
+    /**
+     * True if the prices follow the token statistics.
+     */
+    bool m_entropyCoded{false};
+
+    /**
+     * Price of the pair in the fixed width format.
+     */
+    std::size_t m_pairPrice{0};
+
+    /**
+     * Price of every literal.
+     */
+    std::array<uint32_t, LZSS_HUFFMAN_LITERAL_COUNT> m_literalPrices{};
+
+    /**
+     * Price of every length slot with its extra bits.
+     */
+    std::vector<uint32_t> m_lengthSlotPrices;
+
+    /**
+     * Price of every distance slot with its extra bits.
+     */
+    std::vector<uint32_t> m_distanceSlotPrices;
+
+    LzssTokenPrices() = default;
+
+public:
+    /**
+     * Create flat prices of the fixed width format.
+     * @param pairBits Number of bits of the pair fields.
+     */
+    explicit LzssTokenPrices(const std::size_t pairBits)
+            : m_pairPrice(1 + pairBits)
+    {
+        m_literalPrices.fill(1 + (8 * BYTE_SIZE));
+    }
+
+    /**
+     * Create prices of the Huffman coded format, all symbols of the same alphabet have the same price
+     * until the first update.
+     * @param header LZSS file header.
+     * @return Prices of the Huffman coded format.
+     */
+    [[nodiscard]] static LzssTokenPrices EntropyCoded(const LzssHeader &header)
+    {
+        LzssTokenPrices prices;
+        prices.m_entropyCoded = true;
+        prices.m_lengthSlotPrices.resize(value_slot_count(header.LBits));
+        prices.m_distanceSlotPrices.resize(value_slot_count(header.SBits));
+        prices.update(LzssTokenBuffer());
+        return prices;
+    }
+
+    /**
+     * Reprice the symbols by the code lengths of the token statistics. Every symbol is counted at least once,
+     * so the unseen symbols stay possible. Flat prices are not changed.
+     * @param tokens Tokens of the previous block.
+     */
+    void update(const LzssTokenBuffer &tokens)
+    {
+        if (!m_entropyCoded)
+            return;
+
+        std::vector<uint32_t> literalLengthHistogram(LZSS_HUFFMAN_LITERAL_COUNT + m_lengthSlotPrices.size(), 1);
+        std::vector<uint32_t> distanceHistogram(m_distanceSlotPrices.size(), 1);
+        for (const azgra::byte literal : tokens.literals())
+        {
+            ++literalLengthHistogram[literal];
+        }
+        for (const uint32_t length : tokens.lengths())
+        {
+            ++literalLengthHistogram[LZSS_HUFFMAN_LITERAL_COUNT + value_slot(length - LZSS_HUFFMAN_MIN_MATCH)];
+        }
+        for (const uint32_t distance : tokens.distances())
+        {
+            ++distanceHistogram[value_slot(distance - 1)];
+        }
+
+        const auto literalLengthCodeLengths = huffman::build_code_lengths(literalLengthHistogram);
+        const auto distanceCodeLengths = huffman::build_code_lengths(distanceHistogram);
+        for (std::size_t literal = 0; literal < LZSS_HUFFMAN_LITERAL_COUNT; ++literal)
+        {
+            m_literalPrices[literal] = literalLengthCodeLengths[literal];
+        }
+        for (std::size_t slot = 0; slot < m_lengthSlotPrices.size(); ++slot)
+        {
+            m_lengthSlotPrices[slot] = literalLengthCodeLengths[LZSS_HUFFMAN_LITERAL_COUNT + slot] + slot_extra_bits(slot);
+        }
+        for (std::size_t slot = 0; slot < m_distanceSlotPrices.size(); ++slot)
+        {
+            m_distanceSlotPrices[slot] = distanceCodeLengths[slot] + slot_extra_bits(slot);
+        }
+    }
+
+    [[nodiscard]] inline std::size_t raw_byte_price(const azgra::byte byte) const
+    {
+        return m_literalPrices[byte];
+    }
+
+    [[nodiscard]] inline std::size_t pair_price(const std::size_t distance, const std::size_t length) const
+    {
+        if (!m_entropyCoded)
+            return m_pairPrice;
+        return m_lengthSlotPrices[value_slot(length - LZSS_HUFFMAN_MIN_MATCH)] + m_distanceSlotPrices[value_slot(distance - 1)];
+    }
+};
+
+/**
+ * Buffers the tokens of the block and writes every flag group with its flag byte.
+ */
+class LzssTokenWriter
+{
+private:
+    azgra::io::stream::OutMemoryBitStream m_encoderStream;
+    azgra::byte m_SBits{0};
+    azgra::byte m_LBits{0};
+
+    /**
+     * Tokens of the current block.
+     */
+    LzssTokenBuffer m_tokens{LZSS_TOKEN_BLOCK_SIZE};
+
+    /**
+     * Write the buffered tokens. Every block except the last one ends on the flag group boundary.
+     */
+    void flush_block()
+    {
+        const azgra::byte *literal = m_tokens.literals().data();
+        const uint32_t *length = m_tokens.lengths().data();
+        const uint32_t *distance = m_tokens.distances().data();
+        const std::size_t tokenCount = m_tokens.token_count();
+        for (std::size_t token = 0; token < tokenCount; token += FLAG_GROUP_SIZE)
+        {
+            azgra::byte flags = m_tokens.flags()[token / FLAG_GROUP_SIZE];
+            m_encoderStream.write_value(flags);
+            const std::size_t groupSize = std::min(FLAG_GROUP_SIZE, tokenCount - token);
+            for (std::size_t i = 0; i < groupSize; ++i, flags >>= 1u)
+            {
+                if (IS_PAIR_FLAG(flags & 1u))
+                {
+                    m_encoderStream.write_value(static_cast<std::size_t>(*distance++), m_SBits);
+                    m_encoderStream.write_value(static_cast<std::size_t>(*length++), m_LBits);
+                }
+                else
+                {
+                    m_encoderStream.write_value(*literal++);
+                }
+            }
+        }
+
+        longestMatch = std::max(longestMatch, m_tokens.longest_match());
+        rawCount += m_tokens.literal_count();
+        pairCount += m_tokens.pair_count();
+        m_tokens.clear();
+    }
+
+public:
+    /**
+     * Statistics of the written tokens.
+     */
+    std::size_t longestMatch{0};
+    std::size_t rawCount{0};
+    std::size_t pairCount{0};
+
+    /**
+     * Create the writer and write the header.
+     * @param header LZSS file header.
+     */
+    explicit LzssTokenWriter(LzssHeader header) : m_SBits(header.SBits), m_LBits(header.LBits)
+    {
+        header.write_to_encoder_stream(m_encoderStream);
+    }
+
+    void write_raw_byte(const azgra::byte byte)
+    {
+        m_tokens.push_raw_byte(byte);
+        if (m_tokens.token_count() == LZSS_TOKEN_BLOCK_SIZE)
+        {
+            flush_block();
+        }
+    }
+
+    void write_pair(const LzMatch &match)
+    {
+        m_tokens.push_pair(match);
+        if (m_tokens.token_count() == LZSS_TOKEN_BLOCK_SIZE)
+        {
+            flush_block();
+        }
+    }
+
+    /**
+     * Get prices of the tokens, the pair fields take SBits and LBits bits.
+     * @param header LZSS file header.
+     * @return Flat prices of the format.
+     */
+    static LzssTokenPrices token_prices(const LzssHeader &header)
+    {
+        return LzssTokenPrices(header.SBits + header.LBits);
+    }
+
+    /**
+     * Write the last block and take the encoded bytes.
+     * @return Encoded bytes.
+     */
+    azgra::ByteArray finish()
+    {
+        flush_block();
+        return m_encoderStream.get_flushed_buffer();
+    }
+};
+
+/**
+ * Get number of bytes of the byte aligned field.
+ * @param bits Number of bits of the value.
+ * @return Field size, 1, 2 or 4 bytes.
+ */
+static std::size_t byte_aligned_field_size(const azgra::byte bits)
+{
+    always_assert(bits <= 32 && "Byte aligned LZSS fields are at most 32 bit.");
+    return (bits <= 8) ? 1 : ((bits <= 16) ? 2 : 4);
+}
+
+/**
+ * Append little endian value to the bytes.
+ * @param bytes Output bytes.
+ * @param value Written value.
+ * @param size Number of written bytes.
+ */
+static void append_little_endian(azgra::ByteArray &bytes, const std::size_t value, const std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        bytes.push_back(static_cast<azgra::byte>(value >> (8 * i)));
+    }
+}
+
+/**
+ * Read little endian value of the byte aligned field.
+ * @tparam Size Number of bytes of the field.
+ * @param bytes Field bytes.
+ * @return Field value.
+ */
+template<std::size_t Size>
+static inline std::size_t read_little_endian(const azgra::byte *bytes)
+{
+    std::size_t value = 0;
+    for (std::size_t i = 0; i < Size; ++i)
+    {
+        value |= static_cast<std::size_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Buffers the tokens of the block and appends them to the separate byte aligned sections of the flags, literals,
+ * lengths and distances.
+ */
+class LzssByteTokenWriter
+{
+private:
+    LzssHeader m_header;
+    std::size_t m_lengthSize{0};
+    std::size_t m_distanceSize{0};
+
+    /**
+     * Flags of all tokens, bit is set for the pair token.
+     */
+    azgra::ByteArray m_flags;
+    azgra::ByteArray m_literals;
+    azgra::ByteArray m_lengths;
+    azgra::ByteArray m_distances;
+
+    /**
+     * Tokens of the current block.
+     */
+    LzssTokenBuffer m_tokens{LZSS_TOKEN_BLOCK_SIZE};
+
+    /**
+     * Append the buffered tokens to the sections.
+     */
+    void flush_block()
+    {
+        // NOTE(Moravec): Blocks end on the flag group boundary, so the flag bytes of the block are appended as they are.
+        m_flags.insert(m_flags.end(), m_tokens.flags().begin(), m_tokens.flags().end());
+        m_literals.insert(m_literals.end(), m_tokens.literals().begin(), m_tokens.literals().end());
+        for (const uint32_t length : m_tokens.lengths())
+        {
+            append_little_endian(m_lengths, length, m_lengthSize);
+        }
+        for (const uint32_t distance : m_tokens.distances())
+        {
+            append_little_endian(m_distances, distance, m_distanceSize);
+        }
+
+        longestMatch = std::max(longestMatch, m_tokens.longest_match());
+        rawCount += m_tokens.literal_count();
+        pairCount += m_tokens.pair_count();
+        m_tokens.clear();
+    }
+
+public:
+    /**
+     * Statistics of the written tokens.
+     */
+    std::size_t longestMatch{0};
+    std::size_t rawCount{0};
+    std::size_t pairCount{0};
+
+    /**
+     * Create the writer, header is written by finish().
+     * @param header LZSS file header.
+     */
+    explicit LzssByteTokenWriter(const LzssHeader &header)
+            : m_header(header), m_lengthSize(byte_aligned_field_size(header.LBits)),
+              m_distanceSize(byte_aligned_field_size(header.SBits))
+    {
+    }
+
+    void write_raw_byte(const azgra::byte byte)
+    {
+        m_tokens.push_raw_byte(byte);
+        if (m_tokens.token_count() == LZSS_TOKEN_BLOCK_SIZE)
+        {
+            flush_block();
+        }
+    }
+
+    void write_pair(const LzMatch &match)
+    {
+        m_tokens.push_pair(match);
+        if (m_tokens.token_count() == LZSS_TOKEN_BLOCK_SIZE)
+        {
+            flush_block();
+        }
+    }
+
+    /**
+     * Get prices of the tokens, the pair fields take whole bytes.
+     * @param header LZSS file header.
+     * @return Flat prices of the format.
+     */
+    static LzssTokenPrices token_prices(const LzssHeader &header)
+    {
+        return LzssTokenPrices(8 * (byte_aligned_field_size(header.SBits) + byte_aligned_field_size(header.LBits)));
+    }
+
+    /**
+     * Write the header and all sections.
+     * @return Encoded bytes.
+     */
+    azgra::ByteArray finish()
+    {
+        flush_block();
+        azgra::ByteArray encodedBytes;
+        encodedBytes.reserve(LZSS_BYTE_ALIGNED_HEADER_SIZE + m_flags.size() + m_literals.size() +
+                             m_lengths.size() + m_distances.size());
+        append_little_endian(encodedBytes, m_header.fileSize, 8);
+        encodedBytes.push_back(m_header.SBits);
+        encodedBytes.push_back(m_header.LBits);
+        append_little_endian(encodedBytes, rawCount, 8);
+        append_little_endian(encodedBytes, pairCount, 8);
+        encodedBytes.insert(encodedBytes.end(), m_flags.begin(), m_flags.end());
+        encodedBytes.insert(encodedBytes.end(), m_literals.begin(), m_literals.end());
+        encodedBytes.insert(encodedBytes.end(), m_lengths.begin(), m_lengths.end());
+        encodedBytes.insert(encodedBytes.end(), m_distances.begin(), m_distances.end());
+        return encodedBytes;
+    }
+};
+
+/**
+ * Buffers tokens of the block, builds the Huffman codes of the block and writes the block with its code lengths.
+ * Literal/length symbols are the literals followed by the slots of (length - LZSS_HUFFMAN_MIN_MATCH),
+ * distance symbols are the slots of (distance - 1).
+ */
+class LzssHuffmanTokenWriter
+{
+private:
+    OutWordBitStream m_stream;
+
+    /**
+     * Tokens of the current block.
+     */
+    LzssTokenBuffer m_tokens{LZSS_HUFFMAN_BLOCK_TOKEN_COUNT};
+    std::vector<uint32_t> m_literalLengthHistogram;
+    std::vector<uint32_t> m_distanceHistogram;
+
+    /**
+     * Write the slot code followed by the extra bits of the value.
+     */
+    inline void write_slot_value(const huffman::HuffmanCode &code, const std::size_t slot, const std::size_t value)
+    {
+        m_stream.write_bits(code.bits, code.length);
+        const azgra::byte extraBits = slot_extra_bits(slot);
+        m_stream.write_bits(value - slot_base(slot), extraBits);
+    }
+
+    /**
+     * Write the code lengths and the tokens of the current block.
+     */
+    void flush_block()
+    {
+        if (m_tokens.token_count() == 0)
+            return;
+
+        std::fill(m_literalLengthHistogram.begin(), m_literalLengthHistogram.end(), 0);
+        std::fill(m_distanceHistogram.begin(), m_distanceHistogram.end(), 0);
+        for (const azgra::byte literal : m_tokens.literals())
+        {
+            ++m_literalLengthHistogram[literal];
+        }
+        for (const uint32_t length : m_tokens.lengths())
+        {
+            ++m_literalLengthHistogram[LZSS_HUFFMAN_LITERAL_COUNT + value_slot(length - LZSS_HUFFMAN_MIN_MATCH)];
+        }
+        for (const uint32_t distance : m_tokens.distances())
+        {
+            ++m_distanceHistogram[value_slot(distance - 1)];
+        }
+
+        const auto literalLengthCodeLengths = huffman::build_code_lengths(m_literalLengthHistogram);
+        const auto distanceCodeLengths = huffman::build_code_lengths(m_distanceHistogram);
+        m_stream.write_value(static_cast<uint32_t>(m_tokens.token_count()));
+        huffman::write_code_lengths(m_stream, literalLengthCodeLengths);
+        huffman::write_code_lengths(m_stream, distanceCodeLengths);
+
+        const huffman::CanonicalHuffmanCode literalLengthCode = huffman::create_canonical_code(literalLengthCodeLengths);
+        const huffman::CanonicalHuffmanCode distanceCode = huffman::create_canonical_code(distanceCodeLengths);
+        const azgra::byte *literal = m_tokens.literals().data();
+        const uint32_t *length = m_tokens.lengths().data();
+        const uint32_t *distance = m_tokens.distances().data();
+        const std::size_t tokenCount = m_tokens.token_count();
+        for (std::size_t token = 0; token < tokenCount; token += FLAG_GROUP_SIZE)
+        {
+            azgra::byte flags = m_tokens.flags()[token / FLAG_GROUP_SIZE];
+            const std::size_t groupSize = std::min(FLAG_GROUP_SIZE, tokenCount - token);
+            for (std::size_t i = 0; i < groupSize; ++i, flags >>= 1u)
+            {
+                if (IS_RAW_BYTE_FLAG(flags & 1u))
+                {
+                    const huffman::HuffmanCode &code = literalLengthCode.codes[*literal++];
+                    m_stream.write_bits(code.bits, code.length);
+                    continue;
+                }
+                const std::size_t lengthValue = *length++ - LZSS_HUFFMAN_MIN_MATCH;
+                const std::size_t lengthSlot = value_slot(lengthValue);
+                write_slot_value(literalLengthCode.codes[LZSS_HUFFMAN_LITERAL_COUNT + lengthSlot], lengthSlot, lengthValue);
+                const std::size_t distanceValue = *distance++ - 1;
+                const std::size_t distanceSlot = value_slot(distanceValue);
+                write_slot_value(distanceCode.codes[distanceSlot], distanceSlot, distanceValue);
+            }
+        }
+
+        longestMatch = std::max(longestMatch, m_tokens.longest_match());
+        rawCount += m_tokens.literal_count();
+        pairCount += m_tokens.pair_count();
+        m_tokens.clear();
+    }
+
+public:
+    /**
+     * Statistics of the written tokens.
+     */
+    std::size_t longestMatch{0};
+    std::size_t rawCount{0};
+    std::size_t pairCount{0};
+
+    /**
+     * Create the writer and write the header.
+     * @param header LZSS file header.
+     */
+    explicit LzssHuffmanTokenWriter(const LzssHeader &header)
+    {
+        m_stream.write_value(static_cast<uint64_t>(header.fileSize));
+        m_stream.write_value(header.SBits);
+        m_stream.write_value(header.LBits);
+        m_literalLengthHistogram.resize(LZSS_HUFFMAN_LITERAL_COUNT + value_slot_count(header.LBits));
+        m_distanceHistogram.resize(value_slot_count(header.SBits));
+    }
+
+    void write_raw_byte(const azgra::byte byte)
     {
-        if (tokens[fId].is_pair())
+        m_tokens.push_raw_byte(byte);
+        if (m_tokens.token_count() == LZSS_HUFFMAN_BLOCK_TOKEN_COUNT)
         {
-            encoderStream.write_value(tokens[fId].get_match().distance, SBits);
-            encoderStream.write_value(tokens[fId].get_match().length, LBits);
+            flush_block();
+        }
+    }
+
+    void write_pair(const LzMatch &match)
+    {
+        always_assert(match.length >= LZSS_HUFFMAN_MIN_MATCH && match.distance > 0);
+        m_tokens.push_pair(match);
+        if (m_tokens.token_count() == LZSS_HUFFMAN_BLOCK_TOKEN_COUNT)
+        {
+            flush_block();
+        }
+    }
+
+    /**
+     * Get prices of the tokens, they follow the code lengths of the token statistics.
+     * @param header LZSS file header.
+     * @return Entropy coded prices.
+     */
+    static LzssTokenPrices token_prices(const LzssHeader &header)
+    {
+        return LzssTokenPrices::EntropyCoded(header);
+    }
+
+    /**
+     * Write the last block and take the encoded bytes.
+     * @return Encoded bytes.
+     */
+    azgra::ByteArray finish()
+    {
+        flush_block();
+        return m_stream.get_flushed_buffer();
+    }
+};
+
+template<typename TokenWriter>
+static LzssResult create_lzss_result(TokenWriter &tokenWriter,
+                                     const LzssHeader &header,
+                                     const std::size_t searchBufferSize,
+                                     const std::size_t lookAheadBufferSize)
+{
+    LzssResult result = {};
+    result.originalSize = header.fileSize;
+    result.encodedBytes = tokenWriter.finish();
+    result.encodedBytesCount = result.encodedBytes.size();
+    result.maxMatchSize = tokenWriter.longestMatch;
+    result.pairCount = tokenWriter.pairCount;
+    result.rawBytesCount = tokenWriter.rawCount;
+    result.S = searchBufferSize;
+    result.L = lookAheadBufferSize;
+    result.SBits = header.SBits;
+    result.LBits = header.LBits;
+    result.bps = static_cast<double>(result.encodedBytesCount * 8) / static_cast<double> (header.fileSize);
+    return result;
+}
+
+/**
+ * Greedy parse with the hash chain or the hash binary tree match finder. Data is searched directly,
+ * the window is the range of distances and there is no sliding window object.
+ * Lazy evaluation emits raw bytes instead of the match, when the match of the following position is longer.
+ * History bytes at the beginning of the data are only searched for matches, they are not encoded.
+ * @tparam MatchFinder Match finder with find_best_match(position).
+ * @tparam TokenWriter Writer of the encoded format.
+ */
+template<typename MatchFinder, typename TokenWriter>
+static LzssResult lzss_encode_greedy(const azgra::byte *data,
+                                     const std::size_t dataSize,
+                                     const std::size_t historySize,
+                                     const std::size_t searchBufferSize,
+                                     const std::size_t lookAheadBufferSize,
+                                     const LzssOptions &options)
+{
+    using namespace azgra::io::stream;
+    const auto SBits = static_cast<azgra::byte>(bits_required(searchBufferSize));
+    const auto LBits = static_cast<azgra::byte>(bits_required(lookAheadBufferSize));
+    const std::size_t lazySteps = std::min(options.lazyMatchSteps, LZSS_MAX_LAZY_STEPS);
+
+    const LzssHeader header(dataSize - historySize, SBits, LBits);
+    TokenWriter tokenWriter(header);
+
+    MatchFinder matchFinder(data, dataSize, searchBufferSize, lookAheadBufferSize,
+                            options.maxChainLength, options.goodMatchLength);
+
+    // NOTE(Moravec): Match finders take every position once, matches of the lazy positions are kept for later.
+    std::array<LzMatch, LZSS_MAX_LAZY_STEPS + 1> lookAhead;
+    std::size_t lookAheadCount = 0;
+    std::size_t position = historySize;
+    const auto match_at = [&](const std::size_t step) -> LzMatch
+    {
+        for (; lookAheadCount <= step; ++lookAheadCount)
+        {
+            lookAhead[lookAheadCount] = matchFinder.find_best_match(position + lookAheadCount);
+        }
+        return lookAhead[step];
+    };
+
+    while (position < dataSize)
+    {
+        const LzMatch match = match_at(0);
+        std::size_t shift = 1;
+        if (match.length >= LZ_HASH_CHAIN_MIN_MATCH)
+        {
+            std::size_t rawBytes = 0;
+            if (match.length < options.goodMatchLength)
+            {
+                for (std::size_t step = 1; (step <= lazySteps) && (position + step < dataSize); ++step)
+                {
+                    // Every raw byte before the later match has to be paid by the longer match.
+                    if (match_at(step).length > (match.length + step - 1))
+                    {
+                        rawBytes = step;
+                        break;
+                    }
+                }
+            }
+
+            if (rawBytes > 0)
+            {
+                for (std::size_t i = 0; i < rawBytes; ++i)
+                {
+                    tokenWriter.write_raw_byte(data[position + i]);
+                }
+                shift = rawBytes;
+            }
+            else
+            {
+                tokenWriter.write_pair(match);
+                shift = match.length;
+            }
         }
         else
         {
-            encoderStream.write_value(tokens[fId].get_byte());
+            tokenWriter.write_raw_byte(data[position]);
+        }
+
+        position += shift;
+        if (shift < lookAheadCount)
+        {
+            std::copy(lookAhead.begin() + shift, lookAhead.begin() + lookAheadCount, lookAhead.begin());
+            lookAheadCount -= shift;
+        }
+        else
+        {
+            lookAheadCount = 0;
         }
     }
+    return create_lzss_result(tokenWriter, header, searchBufferSize, lookAheadBufferSize);
 }
 
-LzssResult lzss_encode(const azgra::ByteArray &data,
-                       const std::size_t searchBufferSize,
-                       const std::size_t lookAheadBufferSize)
+/**
+ * Node of the optimal parse, the cheapest token sequence ending at the block position.
+ */
+struct LzssParseNode
+{
+    /**
+     * Price of the cheapest parse of the block prefix.
+     */
+    std::size_t price{std::numeric_limits<std::size_t>::max()};
+
+    /**
+     * Length of the last token of the cheapest parse.
+     */
+    uint32_t length{0};
+
+    /**
+     * Distance of the last token, zero for the raw byte.
+     */
+    uint32_t distance{0};
+};
+
+/**
+ * Optimal parse with the hash binary tree match finder. All match candidates of the block positions are priced
+ * and the cheapest token sequence through the block is found by the forward dynamic programming.
+ * History bytes at the beginning of the data are only searched for matches, they are not encoded.
+ * @tparam TokenWriter Writer of the encoded format.
+ */
+template<typename TokenWriter>
+static LzssResult lzss_encode_optimal(const azgra::byte *data,
+                                      const std::size_t dataSize,
+                                      const std::size_t historySize,
+                                      const std::size_t searchBufferSize,
+                                      const std::size_t lookAheadBufferSize,
+                                      const LzssOptions &options)
+{
+    using namespace azgra::io::stream;
+    const auto SBits = static_cast<azgra::byte>(bits_required(searchBufferSize));
+    const auto LBits = static_cast<azgra::byte>(bits_required(lookAheadBufferSize));
+
+    const LzssHeader header(dataSize - historySize, SBits, LBits);
+    TokenWriter tokenWriter(header);
+    LzssTokenPrices prices = TokenWriter::token_prices(header);
+
+    BinaryTreeMatchFinder matchFinder(data, dataSize, searchBufferSize, lookAheadBufferSize,
+                                      options.maxChainLength, options.goodMatchLength);
+    std::vector<LzMatch> matches;
+    std::vector<LzssParseNode> parseNodes(LZSS_OPTIMAL_BLOCK_SIZE + 1);
+    std::vector<LzMatch> tokens;
+    // NOTE(Moravec): Entropy coded prices of the next block follow the statistics of the parsed block.
+    LzssTokenBuffer blockTokens(LZSS_OPTIMAL_BLOCK_SIZE);
+
+    for (std::size_t blockStart = historySize; blockStart < dataSize; blockStart += LZSS_OPTIMAL_BLOCK_SIZE)
+    {
+        const std::size_t blockSize = std::min(LZSS_OPTIMAL_BLOCK_SIZE, dataSize - blockStart);
+        std::fill(parseNodes.begin(), parseNodes.begin() + blockSize + 1, LzssParseNode());
+        parseNodes[0].price = 0;
+
+        for (std::size_t i = 0; i < blockSize; ++i)
+        {
+            const std::size_t price = parseNodes[i].price;
+            const std::size_t rawPrice = price + prices.raw_byte_price(data[blockStart + i]);
+            if (rawPrice < parseNodes[i + 1].price)
+            {
+                parseNodes[i + 1] = {rawPrice, 1, 0};
+            }
+
+            // NOTE(Moravec): Every length up to the match length is available with the match distance,
+            //                matches are ordered by length, so the shortest distance is used for every length.
+            matchFinder.find_matches(blockStart + i, matches);
+            const std::size_t maxLength = blockSize - i;
+            std::size_t length = LZ_HASH_CHAIN_MIN_MATCH;
+            for (const LzMatch &match : matches)
+            {
+                const std::size_t matchEnd = std::min(match.length, maxLength);
+                for (; length <= matchEnd; ++length)
+                {
+                    const std::size_t pairPrice = price + prices.pair_price(match.distance, length);
+                    if (pairPrice < parseNodes[i + length].price)
+                    {
+                        parseNodes[i + length] = {pairPrice, static_cast<uint32_t>(length), static_cast<uint32_t>(match.distance)};
+                    }
+                }
+            }
+        }
+
+        tokens.clear();
+        for (std::size_t i = blockSize; i > 0; i -= parseNodes[i].length)
+        {
+            tokens.emplace_back(parseNodes[i].distance, parseNodes[i].length);
+        }
+
+        std::size_t position = blockStart;
+        for (auto token = tokens.rbegin(); token != tokens.rend(); ++token)
+        {
+            if (token->distance == 0)
+            {
+                tokenWriter.write_raw_byte(data[position]);
+                blockTokens.push_raw_byte(data[position]);
+            }
+            else
+            {
+                tokenWriter.write_pair(*token);
+                blockTokens.push_pair(*token);
+            }
+            position += token->length;
+        }
+        prices.update(blockTokens);
+        blockTokens.clear();
+    }
+    return create_lzss_result(tokenWriter, header, searchBufferSize, lookAheadBufferSize);
+}
+
+LzssOptions LzssOptions::CompressionLevel(const int level)
+{
+    always_assert(level >= LZSS_MIN_LEVEL && level <= LZSS_MAX_LEVEL && "LZSS compression level is from 1 to 9.");
+    struct LevelParameters
+    {
+        LzssMatchFinder matchFinder;
+        std::size_t maxChainLength;
+        LzssParsing parsing;
+        std::size_t lazyMatchSteps;
+        std::size_t goodMatchLength;
+    };
+    constexpr std::size_t NoCutoff = std::numeric_limits<std::size_t>::max();
+    constexpr std::array<LevelParameters, LZSS_MAX_LEVEL> levels = {{
+            {LzssMatchFinder::HashChain, 4, LzssParsing::Greedy, 0, 8},
+            {LzssMatchFinder::HashChain, 8, LzssParsing::Greedy, 0, 16},
+            {LzssMatchFinder::HashChain, 16, LzssParsing::Greedy, 1, 16},
+            {LzssMatchFinder::HashChain, 32, LzssParsing::Greedy, 1, 32},
+            {LzssMatchFinder::HashChain, 64, LzssParsing::Greedy, 2, 32},
+            {LzssMatchFinder::HashChain, 128, LzssParsing::Greedy, 2, 64},
+            {LzssMatchFinder::HashBinaryTree, 32, LzssParsing::Greedy, 2, 128},
+            {LzssMatchFinder::HashBinaryTree, 16, LzssParsing::Optimal, 0, 32},
+            {LzssMatchFinder::HashBinaryTree, 128, LzssParsing::Optimal, 0, NoCutoff}
+    }};
+
+    const LevelParameters &parameters = levels[level - LZSS_MIN_LEVEL];
+    LzssOptions options(parameters.matchFinder, parameters.maxChainLength, parameters.parsing);
+    options.lazyMatchSteps = parameters.lazyMatchSteps;
+    options.goodMatchLength = parameters.goodMatchLength;
+    return options;
+}
+
+/**
+ * Greedy parse with the binary search tree over the sliding window.
+ * @tparam TokenWriter Writer of the encoded format.
+ */
+template<typename TokenWriter>
+static LzssResult lzss_encode_binary_tree(const azgra::byte *data,
+                                          const std::size_t dataSize,
+                                          const std::size_t searchBufferSize,
+                                          const std::size_t lookAheadBufferSize)
 {
     // NOTE(Moravec):   We are going to cheat and hold the whole data buffer in memory
     //                  instead of reading from the stream.
@@ -32,7 +851,7 @@ LzssResult lzss_encode(const azgra::ByteArray &data,
 
     using namespace azgra::io::stream;
 
-    const std::size_t inputBufferSize = data.size();
+    const std::size_t inputBufferSize = dataSize;
 
 
     const auto SBits = static_cast<azgra::byte>(azgra::io::stream::bits_required(searchBufferSize));
@@ -41,46 +860,33 @@ LzssResult lzss_encode(const azgra::ByteArray &data,
 
     //fprintf(stdout, "S=%lu(%ub)\tL=%lu(%ub)\tW=%lu\n", searchBufferSize, SBits, lookAheadBufferSize, LBits, slidingWindowSize);
 
-    // Binary search tree.
-    ByteLzTree bst;
+    // Binary search tree, the pool holds every position of the sliding window.
+    ByteLzTree bst(data, dataSize, slidingWindowSize);
 
     // Last shift of the window.
     std::size_t windowShift = 0;
     // Sliding window.
-    SlidingWindow<azgra::byte> window(data.data(), -searchBufferSize, slidingWindowSize, searchBufferSize);
+    SlidingWindow<azgra::byte> window(data, -searchBufferSize, slidingWindowSize, searchBufferSize);
     // Current input buffer index
     std::size_t bufferIndex = lookAheadBufferSize;
 
-    // Encoder stream.
-    OutMemoryBitStream encoderStream;
-
-    LzssHeader header(inputBufferSize, SBits, LBits);
-    header.write_to_encoder_stream(encoderStream);
+    // Encoder of the tokens.
+    const LzssHeader header(inputBufferSize, SBits, LBits);
+    TokenWriter tokenWriter(header);
 
     // String being searched.
     azgra::ByteSpan searchSpan;
     // Match in the binary tree.
     LzMatch searchResult;
 
-    azgra::byte flagBuffer = 0;
-    azgra::byte flagIndex = 0;
-    std::array<LzssToken, FLAG_GROUP_SIZE> interBuffer;
-
-    std::size_t longestMatch = 0;
-    std::size_t rawCount = 0;
-    std::size_t pairCount = 0;
-    double matchSizes = 0.0;
     long long remaining = inputBufferSize;
     while (remaining > 0)
     {
         if (bufferIndex < (2 * lookAheadBufferSize))
         {
             // Before we get at least L elements in search buffer encode values with char code (0,'A')
-            flagBuffer |= static_cast<uint8_t>(RAW_BYTE_FLAG) << flagIndex;
-            interBuffer[flagIndex] = LzssToken::RawByteToken(window[0]);
-            ++flagIndex;
+            tokenWriter.write_raw_byte(window[0]);
             windowShift = 1;
-            ++rawCount;
         }
         else
         {
@@ -111,36 +917,17 @@ LzssResult lzss_encode(const azgra::ByteArray &data,
 
             if (searchResult.length > 1)
             {
-                flagBuffer |= static_cast<uint8_t>(PAIR_FLAG) << flagIndex;
-                interBuffer[flagIndex] = LzssToken::PairToken(searchResult);
-                ++flagIndex;
-
+                tokenWriter.write_pair(searchResult);
                 windowShift = searchResult.length;
-
-                ++pairCount;
-                longestMatch = std::max(longestMatch, searchResult.length);
-                matchSizes += searchResult.length;
             }
             else
             {
                 // Write RAW byte
-                flagBuffer |= static_cast<uint8_t>(RAW_BYTE_FLAG) << flagIndex;
-                interBuffer[flagIndex] = LzssToken::RawByteToken(window[0]);
-                ++flagIndex;
+                tokenWriter.write_raw_byte(window[0]);
                 windowShift = 1;
-                ++rawCount;
             }
         }
 
-        // Flush flag buffer and tokens
-        if (flagIndex >= FLAG_GROUP_SIZE)
-        {
-            encoderStream.write_value(flagBuffer);
-            write_tokens_to_stream(encoderStream, interBuffer, SBits, LBits, flagIndex);
-            flagBuffer = 0;
-            flagIndex = 0;
-        }
-
         bufferIndex += windowShift;
         remaining -= windowShift;
         // Slide the window by the matched string length.
@@ -148,40 +935,82 @@ LzssResult lzss_encode(const azgra::ByteArray &data,
     }
 
     // Flush flag buffer and tokens
-    if (flagIndex > 0)
+    return create_lzss_result(tokenWriter, header, searchBufferSize, lookAheadBufferSize);
+}
+
+/**
+ * Encode with the parsing and the match finder of the options.
+ * @tparam TokenWriter Writer of the encoded format.
+ */
+template<typename TokenWriter>
+static LzssResult lzss_encode_with_writer(const azgra::byte *data,
+                                          const std::size_t dataSize,
+                                          const std::size_t historySize,
+                                          const std::size_t searchBufferSize,
+                                          const std::size_t lookAheadBufferSize,
+                                          const LzssOptions &options)
+{
+    if (options.parsing == LzssParsing::Optimal)
     {
-        encoderStream.write_value(flagBuffer);
-        write_tokens_to_stream(encoderStream, interBuffer, SBits, LBits, flagIndex);
+        return lzss_encode_optimal<TokenWriter>(data, dataSize, historySize, searchBufferSize, lookAheadBufferSize, options);
     }
+    if (options.matchFinder == LzssMatchFinder::HashChain)
+    {
+        return lzss_encode_greedy<HashChainMatchFinder, TokenWriter>(data, dataSize, historySize,
+                                                                     searchBufferSize, lookAheadBufferSize, options);
+    }
+    if (options.matchFinder == LzssMatchFinder::HashBinaryTree)
+    {
+        return lzss_encode_greedy<BinaryTreeMatchFinder, TokenWriter>(data, dataSize, historySize,
+                                                                      searchBufferSize, lookAheadBufferSize, options);
+    }
+    always_assert(historySize == 0 && "Binary search tree encoder can't use the history.");
+    return lzss_encode_binary_tree<TokenWriter>(data, dataSize, searchBufferSize, lookAheadBufferSize);
+}
 
-    LzssResult result = {};
-    result.originalSize = inputBufferSize;
-    result.encodedBytes = encoderStream.get_flushed_buffer();
-    result.encodedBytesCount = result.encodedBytes.size();
-    result.maxMatchSize = longestMatch;
-    result.pairCount = pairCount;
-    result.rawBytesCount = rawCount;
-    result.S = searchBufferSize;
-    result.L = lookAheadBufferSize;
-    result.SBits = SBits;
-    result.LBits = LBits;
-    result.bps = static_cast<double>(result.encodedBytesCount * 8) / static_cast<double> (inputBufferSize);
-
-    return result;
+LzssResult lzss_encode_with_history(const azgra::byte *data,
+                                    const std::size_t dataSize,
+                                    const std::size_t historySize,
+                                    const std::size_t searchBufferSize,
+                                    const std::size_t lookAheadBufferSize,
+                                    const LzssOptions &options)
+{
+    if (options.format == LzssFormat::ByteAligned)
+    {
+        return lzss_encode_with_writer<LzssByteTokenWriter>(data, dataSize, historySize,
+                                                            searchBufferSize, lookAheadBufferSize, options);
+    }
+    if (options.format == LzssFormat::Huffman)
+    {
+        return lzss_encode_with_writer<LzssHuffmanTokenWriter>(data, dataSize, historySize,
+                                                               searchBufferSize, lookAheadBufferSize, options);
+    }
+    return lzss_encode_with_writer<LzssTokenWriter>(data, dataSize, historySize,
+                                                    searchBufferSize, lookAheadBufferSize, options);
 }
 
-azgra::ByteArray lzss_decode(const azgra::ByteArray &encodedBytes)
+LzssResult lzss_encode(const azgra::ByteArray &data,
+                       const std::size_t searchBufferSize,
+                       const std::size_t lookAheadBufferSize,
+                       const LzssOptions &options)
 {
-    azgra::io::stream::InMemoryBitStream decoderStream(&encodedBytes);
-    LzssHeader header;
-    header.read_from_decoder_stream(decoderStream);
+    return lzss_encode_with_history(data.data(), data.size(), 0, searchBufferSize, lookAheadBufferSize, options);
+}
 
+/**
+ * Decode the bit packed tokens after the header. Matches may reach before the output into the decoded history.
+ * @param decoderStream Decoder stream after the header.
+ * @param header LZSS file header.
+ * @param output Output buffer of the header file size.
+ */
+static void decode_bit_packed_tokens(azgra::io::stream::InMemoryBitStream &decoderStream,
+                                     const LzssHeader &header,
+                                     azgra::byte *output)
+{
     std::size_t index = 0;
-    azgra::ByteArray decodedBytes(header.fileSize);
-
     std::size_t distance;
     std::size_t length;
-    std::size_t offset;
+    const azgra::byte *match;
     azgra::byte flagBuffer;
     std::array<bool, FLAG_GROUP_SIZE> flags{};
     while (index < header.fileSize)
@@ -198,7 +1027,7 @@ azgra::ByteArray lzss_decode(const azgra::ByteArray &encodedBytes)
             {
                 if (index >= header.fileSize)
                     break;
-                decodedBytes[index++] = decoderStream.read_value<azgra::byte>();
+                output[index++] = decoderStream.read_value<azgra::byte>();
             }
             else
             {
@@ -206,16 +1035,439 @@ azgra::ByteArray lzss_decode(const azgra::ByteArray &encodedBytes)
                     break;
                 distance = decoderStream.read_value<std::size_t>(header.SBits);
                 length = decoderStream.read_value<std::size_t>(header.LBits);
-                offset = index - distance;
+                match = (output + index) - distance;
 
                 for (std::size_t i = 0; i < length; ++i)
                 {
-                    decodedBytes[index++] = decodedBytes[offset + i];
+                    output[index++] = match[i];
                 }
             }
         }
     }
+}
+
+azgra::ByteArray lzss_decode(const azgra::ByteArray &encodedBytes)
+{
+    azgra::io::stream::InMemoryBitStream decoderStream(&encodedBytes);
+    LzssHeader header;
+    header.read_from_decoder_stream(decoderStream);
 
+    azgra::ByteArray decodedBytes(header.fileSize);
+    decode_bit_packed_tokens(decoderStream, header, decodedBytes.data());
+    return decodedBytes;
+}
+
+/**
+ * Sections of the byte aligned format.
+ */
+struct LzssByteAlignedSections
+{
+    std::size_t fileSize{0};
+    std::size_t literalCount{0};
+    std::size_t pairCount{0};
+    std::size_t lengthSize{0};
+    std::size_t distanceSize{0};
+    const azgra::byte *flags{nullptr};
+    const azgra::byte *literals{nullptr};
+    const azgra::byte *lengths{nullptr};
+    const azgra::byte *distances{nullptr};
+};
+
+static LzssByteAlignedSections read_byte_aligned_sections(const azgra::byte *encodedBytes, const std::size_t encodedSize)
+{
+    always_assert(encodedSize >= LZSS_BYTE_ALIGNED_HEADER_SIZE && "Corrupted LZSS data.");
+    LzssByteAlignedSections sections;
+    sections.fileSize = read_little_endian<8>(encodedBytes);
+    sections.distanceSize = byte_aligned_field_size(encodedBytes[8]);
+    sections.lengthSize = byte_aligned_field_size(encodedBytes[9]);
+    sections.literalCount = read_little_endian<8>(encodedBytes + 10);
+    sections.pairCount = read_little_endian<8>(encodedBytes + 18);
+
+    const std::size_t tokenCount = sections.literalCount + sections.pairCount;
+    const std::size_t flagsSize = (tokenCount + FLAG_GROUP_SIZE - 1) / FLAG_GROUP_SIZE;
+    sections.flags = encodedBytes + LZSS_BYTE_ALIGNED_HEADER_SIZE;
+    sections.literals = sections.flags + flagsSize;
+    sections.lengths = sections.literals + sections.literalCount;
+    sections.distances = sections.lengths + (sections.pairCount * sections.lengthSize);
+    always_assert((sections.distances + (sections.pairCount * sections.distanceSize)) == (encodedBytes + encodedSize) &&
+                  "Corrupted LZSS data.");
+    return sections;
+}
+
+/**
+ * Copy the match to the output. Matches with the distance of at least the copy size are copied by the wide
+ * copies, which may write up to the copy size - 1 bytes after the match, if the output has room for it.
+ * Overlapping matches with short distance are copied byte by byte.
+ * @param output Output position.
+ * @param outputEnd End of the output buffer.
+ * @param distance Match distance.
+ * @param length Match length.
+ */
+static inline void copy_match(azgra::byte *output, const azgra::byte *outputEnd, const std::size_t distance, const std::size_t length)
+{
+    const azgra::byte *match = output - distance;
+    const auto room = static_cast<std::size_t>(outputEnd - output);
+    if ((distance >= LZSS_WIDE_COPY_SIZE) && (room >= (length + LZSS_WIDE_COPY_SIZE - 1)))
+    {
+        for (std::size_t i = 0; i < length; i += LZSS_WIDE_COPY_SIZE)
+        {
+            std::memcpy(output + i, match + i, LZSS_WIDE_COPY_SIZE);
+        }
+    }
+    else if ((distance >= sizeof(uint64_t)) && (room >= (length + sizeof(uint64_t) - 1)))
+    {
+        for (std::size_t i = 0; i < length; i += sizeof(uint64_t))
+        {
+            std::memcpy(output + i, match + i, sizeof(uint64_t));
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            output[i] = match[i];
+        }
+    }
+}
+
+/**
+ * Decode the byte aligned tokens.
+ * @tparam LengthSize Number of bytes of the length field.
+ * @tparam DistanceSize Number of bytes of the distance field.
+ * @param sections Sections of the encoded data.
+ * @param output Output buffer of the file size.
+ * @param historySize Number of decoded bytes before the output, which can be referenced by matches.
+ */
+template<std::size_t LengthSize, std::size_t DistanceSize>
+static void decode_byte_aligned_tokens(const LzssByteAlignedSections &sections, azgra::byte *output, const std::size_t historySize)
+{
+    azgra::byte *out = output;
+    const azgra::byte *outEnd = output + sections.fileSize;
+    const azgra::byte *literal = sections.literals;
+    const azgra::byte *literalEnd = sections.literals + sections.literalCount;
+    const azgra::byte *length = sections.lengths;
+    const azgra::byte *distance = sections.distances;
+
+    const std::size_t tokenCount = sections.literalCount + sections.pairCount;
+    for (std::size_t token = 0; token < tokenCount; token += FLAG_GROUP_SIZE)
+    {
+        azgra::byte flags = sections.flags[token / FLAG_GROUP_SIZE];
+        const std::size_t groupSize = std::min(FLAG_GROUP_SIZE, tokenCount - token);
+        if ((flags == 0) && (groupSize == FLAG_GROUP_SIZE) &&
+            (static_cast<std::size_t>(outEnd - out) >= FLAG_GROUP_SIZE) &&
+            (static_cast<std::size_t>(literalEnd - literal) >= FLAG_GROUP_SIZE))
+        {
+            // NOTE(Moravec): Whole group of literals is copied at once.
+            std::memcpy(out, literal, FLAG_GROUP_SIZE);
+            out += FLAG_GROUP_SIZE;
+            literal += FLAG_GROUP_SIZE;
+            continue;
+        }
+
+        for (std::size_t i = 0; i < groupSize; ++i, flags >>= 1u)
+        {
+            if (IS_RAW_BYTE_FLAG(flags & 1u))
+            {
+                always_assert((out < outEnd) && (literal < literalEnd) && "Corrupted LZSS data.");
+                *out++ = *literal++;
+            }
+            else
+            {
+                const std::size_t matchLength = read_little_endian<LengthSize>(length);
+                const std::size_t matchDistance = read_little_endian<DistanceSize>(distance);
+                length += LengthSize;
+                distance += DistanceSize;
+                always_assert((matchDistance > 0) && (matchDistance <= (historySize + static_cast<std::size_t>(out - output))) &&
+                              (matchLength <= static_cast<std::size_t>(outEnd - out)) && "Corrupted LZSS data.");
+                copy_match(out, outEnd, matchDistance, matchLength);
+                out += matchLength;
+            }
+        }
+    }
+    always_assert(out == outEnd && "Corrupted LZSS data.");
+}
+
+std::size_t lzss_byte_aligned_decoded_size(const azgra::byte *encodedBytes, const std::size_t encodedSize)
+{
+    always_assert(encodedSize >= LZSS_BYTE_ALIGNED_HEADER_SIZE && "Corrupted LZSS data.");
+    return read_little_endian<8>(encodedBytes);
+}
+
+/**
+ * Decode data in the byte aligned format, whose matches may reach before the output into the decoded history.
+ * @param encodedBytes Compressed bytes.
+ * @param encodedSize Number of compressed bytes.
+ * @param output Output buffer.
+ * @param outputCapacity Size of the output buffer.
+ * @param historySize Number of decoded bytes before the output.
+ * @return Number of decompressed bytes.
+ */
+static std::size_t decode_byte_aligned(const azgra::byte *encodedBytes,
+                                       const std::size_t encodedSize,
+                                       azgra::byte *output,
+                                       const std::size_t outputCapacity,
+                                       const std::size_t historySize)
+{
+    const LzssByteAlignedSections sections = read_byte_aligned_sections(encodedBytes, encodedSize);
+    always_assert(outputCapacity >= sections.fileSize && "Output buffer is too small.");
+
+    // NOTE(Moravec): Field sizes are template arguments, so the fields are read by single loads.
+    const std::size_t fieldSizes = (sections.lengthSize << 4u) | sections.distanceSize;
+    switch (fieldSizes)
+    {
+        case 0x11:
+            decode_byte_aligned_tokens<1, 1>(sections, output, historySize);
+            break;
+        case 0x12:
+            decode_byte_aligned_tokens<1, 2>(sections, output, historySize);
+            break;
+        case 0x14:
+            decode_byte_aligned_tokens<1, 4>(sections, output, historySize);
+            break;
+        case 0x21:
+            decode_byte_aligned_tokens<2, 1>(sections, output, historySize);
+            break;
+        case 0x22:
+            decode_byte_aligned_tokens<2, 2>(sections, output, historySize);
+            break;
+        case 0x24:
+            decode_byte_aligned_tokens<2, 4>(sections, output, historySize);
+            break;
+        case 0x41:
+            decode_byte_aligned_tokens<4, 1>(sections, output, historySize);
+            break;
+        case 0x42:
+            decode_byte_aligned_tokens<4, 2>(sections, output, historySize);
+            break;
+        default:
+            decode_byte_aligned_tokens<4, 4>(sections, output, historySize);
+            break;
+    }
+    return sections.fileSize;
+}
+
+std::size_t lzss_decode_byte_aligned(const azgra::byte *encodedBytes,
+                                     const std::size_t encodedSize,
+                                     azgra::byte *output,
+                                     const std::size_t outputCapacity)
+{
+    return decode_byte_aligned(encodedBytes, encodedSize, output, outputCapacity, 0);
+}
+
+azgra::ByteArray lzss_decode_byte_aligned(const azgra::ByteArray &encodedBytes)
+{
+    azgra::ByteArray decodedBytes(lzss_byte_aligned_decoded_size(encodedBytes.data(), encodedBytes.size()));
+    lzss_decode_byte_aligned(encodedBytes.data(), encodedBytes.size(), decodedBytes.data(), decodedBytes.size());
+    return decodedBytes;
+}
+
+/**
+ * Read the extra bits of the slot value, the stream has to be refilled for them.
+ */
+static inline std::size_t read_slot_value(InWordBitStream &stream, const std::size_t slot)
+{
+    const azgra::byte extraBits = slot_extra_bits(slot);
+    std::size_t value = slot_base(slot);
+    if (extraBits > 0)
+    {
+        value += stream.peek_bits(extraBits);
+        stream.consume_bits(extraBits);
+    }
+    return value;
+}
+
+/**
+ * Decode the Huffman coded blocks after the header.
+ * @param stream Decoder stream after the header.
+ * @param header LZSS file header.
+ * @param output Output buffer of the header file size.
+ * @param historySize Number of decoded bytes before the output, which can be referenced by matches.
+ */
+static void decode_huffman_tokens(InWordBitStream &stream,
+                                  const LzssHeader &header,
+                                  azgra::byte *output,
+                                  const std::size_t historySize)
+{
+    const std::size_t literalLengthCount = LZSS_HUFFMAN_LITERAL_COUNT + value_slot_count(header.LBits);
+    const std::size_t distanceCount = value_slot_count(header.SBits);
+    const azgra::byte *outputEnd = output + header.fileSize;
+    std::size_t index = 0;
+    while (index < header.fileSize)
+    {
+        const auto tokenCount = stream.read_value<uint32_t>();
+        always_assert(tokenCount > 0 && "Corrupted LZSS data.");
+        const auto literalLengthTable = huffman::create_decode_table(huffman::read_code_lengths(stream, literalLengthCount));
+        const auto distanceTable = huffman::create_decode_table(huffman::read_code_lengths(stream, distanceCount));
+
+        for (uint32_t token = 0; token < tokenCount; ++token)
+        {
+            // NOTE(Moravec): Codes are limited to 15 bits, symbol with its extra bits fits into single refill.
+            stream.refill();
+            const uint16_t symbol = huffman::decode_symbol(literalLengthTable, stream);
+            if (symbol < LZSS_HUFFMAN_LITERAL_COUNT)
+            {
+                always_assert(index < header.fileSize && "Corrupted LZSS data.");
+                output[index++] = static_cast<azgra::byte>(symbol);
+                continue;
+            }
+            const std::size_t length = LZSS_HUFFMAN_MIN_MATCH + read_slot_value(stream, symbol - LZSS_HUFFMAN_LITERAL_COUNT);
+            stream.refill();
+            const std::size_t distance = 1 + read_slot_value(stream, huffman::decode_symbol(distanceTable, stream));
+            always_assert((distance <= (historySize + index)) && (length <= (header.fileSize - index)) &&
+                          "Corrupted LZSS data.");
+            copy_match(output + index, outputEnd, distance, length);
+            index += length;
+        }
+    }
+}
+
+/**
+ * Decode data in the Huffman coded format, whose matches may reach before the output into the decoded history.
+ * @param encodedBytes Compressed bytes.
+ * @param encodedSize Number of compressed bytes.
+ * @param output Output buffer.
+ * @param outputCapacity Size of the output buffer.
+ * @param historySize Number of decoded bytes before the output.
+ * @return Number of decompressed bytes.
+ */
+static std::size_t decode_huffman(const azgra::byte *encodedBytes,
+                                  const std::size_t encodedSize,
+                                  azgra::byte *output,
+                                  const std::size_t outputCapacity,
+                                  const std::size_t historySize)
+{
+    InWordBitStream stream(encodedBytes, encodedSize);
+    LzssHeader header;
+    header.fileSize = static_cast<std::size_t>(stream.read_value<uint64_t>());
+    header.SBits = stream.read_value<azgra::byte>();
+    header.LBits = stream.read_value<azgra::byte>();
+    always_assert(outputCapacity >= header.fileSize && "Output buffer is too small.");
+    decode_huffman_tokens(stream, header, output, historySize);
+    return header.fileSize;
+}
+
+azgra::ByteArray lzss_decode_huffman(const azgra::ByteArray &encodedBytes)
+{
+    InWordBitStream stream(encodedBytes.data(), encodedBytes.size());
+    azgra::ByteArray decodedBytes(static_cast<std::size_t>(stream.read_value<uint64_t>()));
+    decode_huffman(encodedBytes.data(), encodedBytes.size(), decodedBytes.data(), decodedBytes.size(), 0);
+    return decodedBytes;
+}
+
+LzssResult lzss_encode_blocks(const azgra::ByteArray &data,
+                              const std::size_t searchBufferSize,
+                              const std::size_t lookAheadBufferSize,
+                              const LzssOptions &options,
+                              const std::size_t blockSize,
+                              const bool primeBlocks)
+{
+    always_assert(blockSize > 0);
+    always_assert((!primeBlocks || options.supports_history()) &&
+                  "Primed blocks need the optimal parsing or the hash match finder.");
+    const std::size_t dataSize = data.size();
+    const auto blockCount = static_cast<long>((dataSize + blockSize - 1) / blockSize);
+
+    std::vector<LzssResult> blockResults(blockCount);
+#pragma omp parallel for default(none) shared(blockResults, data, options) firstprivate(blockCount, blockSize, dataSize, primeBlocks, searchBufferSize, lookAheadBufferSize) schedule(dynamic)
+    for (long block = 0; block < blockCount; ++block)
+    {
+        const std::size_t blockBegin = block * blockSize;
+        const std::size_t blockLength = std::min(blockSize, dataSize - blockBegin);
+        // NOTE(Moravec): Primed block searches the tail of the previous block input, decoder has it already decoded.
+        const std::size_t historySize = primeBlocks ? std::min(searchBufferSize, blockBegin) : 0;
+        blockResults[block] = lzss_encode_with_history(data.data() + (blockBegin - historySize), historySize + blockLength,
+                                                       historySize, searchBufferSize, lookAheadBufferSize, options);
+    }
+
+    // Header with the block index.
+    OutWordBitStream headerStream;
+    headerStream.write_value(static_cast<uint64_t>(dataSize));
+    headerStream.write_value(static_cast<uint64_t>(blockSize));
+    headerStream.write_value(static_cast<azgra::byte>(options.format));
+    headerStream.write_value(static_cast<azgra::byte>(primeBlocks));
+    for (const auto &blockResult : blockResults)
+    {
+        headerStream.write_value(static_cast<uint64_t>(blockResult.encodedBytes.size()));
+    }
+
+    LzssResult result = {};
+    result.encodedBytes = headerStream.get_flushed_buffer();
+    for (const auto &blockResult : blockResults)
+    {
+        result.encodedBytes.insert(result.encodedBytes.end(), blockResult.encodedBytes.begin(), blockResult.encodedBytes.end());
+        result.maxMatchSize = std::max(result.maxMatchSize, blockResult.maxMatchSize);
+        result.pairCount += blockResult.pairCount;
+        result.rawBytesCount += blockResult.rawBytesCount;
+    }
+    result.originalSize = dataSize;
+    result.encodedBytesCount = result.encodedBytes.size();
+    result.S = searchBufferSize;
+    result.L = lookAheadBufferSize;
+    result.SBits = static_cast<azgra::byte>(azgra::io::stream::bits_required(searchBufferSize));
+    result.LBits = static_cast<azgra::byte>(azgra::io::stream::bits_required(lookAheadBufferSize));
+    result.bps = static_cast<double>(result.encodedBytesCount * 8) / static_cast<double> (dataSize);
+    return result;
+}
+
+void lzss_decode_with_history(const LzssFormat format,
+                              const azgra::byte *encodedBytes,
+                              const std::size_t encodedSize,
+                              azgra::byte *output,
+                              const std::size_t decodedSize,
+                              const std::size_t historySize)
+{
+    if (format == LzssFormat::ByteAligned)
+    {
+        const std::size_t blockSize = decode_byte_aligned(encodedBytes, encodedSize, output, decodedSize, historySize);
+        always_assert(blockSize == decodedSize && "Corrupted LZSS block.");
+        return;
+    }
+    if (format == LzssFormat::Huffman)
+    {
+        const std::size_t blockSize = decode_huffman(encodedBytes, encodedSize, output, decodedSize, historySize);
+        always_assert(blockSize == decodedSize && "Corrupted LZSS block.");
+        return;
+    }
+
+    const azgra::ByteArray encodedBlock(encodedBytes, encodedBytes + encodedSize);
+    azgra::io::stream::InMemoryBitStream decoderStream(&encodedBlock);
+    LzssHeader header;
+    header.read_from_decoder_stream(decoderStream);
+    always_assert(header.fileSize == decodedSize && "Corrupted LZSS block.");
+    decode_bit_packed_tokens(decoderStream, header, output);
+}
+
+azgra::ByteArray lzss_decode_blocks(const azgra::ByteArray &encodedBytes)
+{
+    InWordBitStream headerStream(encodedBytes.data(), encodedBytes.size());
+    const auto dataSize = static_cast<std::size_t>(headerStream.read_value<uint64_t>());
+    const auto blockSize = static_cast<std::size_t>(headerStream.read_value<uint64_t>());
+    const auto format = static_cast<LzssFormat>(headerStream.read_value<azgra::byte>());
+    const bool primedBlocks = (headerStream.read_value<azgra::byte>() != 0);
+    const auto blockCount = static_cast<long>((blockSize > 0) ? ((dataSize + blockSize - 1) / blockSize) : 0);
+
+    std::vector<std::size_t> blockOffsets(blockCount + 1);
+    for (long block = 0; block < blockCount; ++block)
+    {
+        blockOffsets[block + 1] = blockOffsets[block] + headerStream.read_value<uint64_t>();
+    }
+    const std::size_t headerSize = headerStream.consumed_bytes();
+    always_assert(headerSize + blockOffsets[blockCount] <= encodedBytes.size());
+
+    // NOTE(Moravec): Primed blocks reference the output of the previous block, so they are decoded in order.
+    azgra::ByteArray decodedBytes(dataSize);
+#pragma omp parallel for if(!primedBlocks) default(none) shared(blockOffsets, encodedBytes, decodedBytes) firstprivate(blockCount, blockSize, dataSize, headerSize, format) schedule(dynamic)
+    for (long block = 0; block < blockCount; ++block)
+    {
+        const std::size_t blockBegin = block * blockSize;
+        const std::size_t blockLength = std::min(blockSize, dataSize - blockBegin);
+        lzss_decode_with_history(format,
+                                 encodedBytes.data() + headerSize + blockOffsets[block],
+                                 blockOffsets[block + 1] - blockOffsets[block],
+                                 decodedBytes.data() + blockBegin,
+                                 blockLength,
+                                 blockBegin);
+    }
     return decodedBytes;
 }
 
@@ -258,6 +1510,67 @@ void test_lzss(const char *inputFile)
     const bool eq3 = std::equal(inputData.begin(), inputData.end(), decodedBytes.begin(), decodedBytes.end());
     report_lzss_result(inputFile, lzssEncodedData3, eq3);
 
+    const LzssResult lzssEncodedData4 = lzss_encode(inputData, 32768, 64, LzssOptions(LzssMatchFinder::HashChain));
+    const auto decodedBytes4 = lzss_decode(lzssEncodedData4.encodedBytes);
+    const bool eq4 = std::equal(inputData.begin(), inputData.end(), decodedBytes4.begin(), decodedBytes4.end());
+    report_lzss_result(inputFile, lzssEncodedData4, eq4);
+
+    const LzssResult lzssEncodedData5 = lzss_encode(inputData, 32768, 64,
+                                                    LzssOptions(LzssMatchFinder::HashBinaryTree, LZ_DEFAULT_TREE_DEPTH));
+    const auto decodedBytes5 = lzss_decode(lzssEncodedData5.encodedBytes);
+    const bool eq5 = std::equal(inputData.begin(), inputData.end(), decodedBytes5.begin(), decodedBytes5.end());
+    report_lzss_result(inputFile, lzssEncodedData5, eq5);
+
+    const LzssResult lzssEncodedData6 = lzss_encode(inputData, 32768, 64,
+                                                    LzssOptions(LzssMatchFinder::HashBinaryTree, LZ_DEFAULT_TREE_DEPTH,
+                                                                LzssParsing::Optimal));
+    const auto decodedBytes6 = lzss_decode(lzssEncodedData6.encodedBytes);
+    const bool eq6 = std::equal(inputData.begin(), inputData.end(), decodedBytes6.begin(), decodedBytes6.end());
+    report_lzss_result(inputFile, lzssEncodedData6, eq6);
+
+    const LzssResult lzssEncodedData7 = lzss_encode(inputData, 32768, 64, LzssOptions::CompressionLevel(LZSS_DEFAULT_LEVEL));
+    const auto decodedBytes7 = lzss_decode(lzssEncodedData7.encodedBytes);
+    const bool eq7 = std::equal(inputData.begin(), inputData.end(), decodedBytes7.begin(), decodedBytes7.end());
+    report_lzss_result(inputFile, lzssEncodedData7, eq7);
+
+    LzssOptions byteAlignedOptions = LzssOptions::CompressionLevel(LZSS_DEFAULT_LEVEL);
+    byteAlignedOptions.format = LzssFormat::ByteAligned;
+    const LzssResult lzssEncodedData8 = lzss_encode(inputData, 32768, 64, byteAlignedOptions);
+    const auto decodedBytes8 = lzss_decode_byte_aligned(lzssEncodedData8.encodedBytes);
+    const bool eq8 = std::equal(inputData.begin(), inputData.end(), decodedBytes8.begin(), decodedBytes8.end());
+    report_lzss_result(inputFile, lzssEncodedData8, eq8);
+
+    const LzssResult lzssEncodedData9 = lzss_encode_blocks(inputData, 32768, 64, byteAlignedOptions, LZSS_DEFAULT_BLOCK_SIZE, true);
+    const auto decodedBytes9 = lzss_decode_blocks(lzssEncodedData9.encodedBytes);
+    const bool eq9 = std::equal(inputData.begin(), inputData.end(), decodedBytes9.begin(), decodedBytes9.end());
+    report_lzss_result(inputFile, lzssEncodedData9, eq9);
+
+    std::istringstream streamInput{std::string(inputData.begin(), inputData.end())};
+    std::ostringstream streamOutput;
+    lzss_encode_stream(streamInput, streamOutput, 32768, 64);
+    const std::string streamEncoded = streamOutput.str();
+    std::istringstream encodedStreamInput{streamEncoded};
+    std::ostringstream decodedStreamOutput;
+    lzss_decode_stream(encodedStreamInput, decodedStreamOutput);
+    const std::string decodedStream = decodedStreamOutput.str();
+    LzssResult lzssEncodedData10 = {};
+    lzssEncodedData10.originalSize = inputData.size();
+    lzssEncodedData10.encodedBytesCount = streamEncoded.size();
+    lzssEncodedData10.S = 32768;
+    lzssEncodedData10.L = 64;
+    lzssEncodedData10.bps = static_cast<double>(streamEncoded.size() * 8) / static_cast<double>(inputData.size());
+    const bool eq10 = std::equal(inputData.begin(), inputData.end(), decodedStream.begin(), decodedStream.end(),
+                                 [](const azgra::byte a, const char b)
+                                 { return a == static_cast<azgra::byte>(b); });
+    report_lzss_result(inputFile, lzssEncodedData10, eq10);
+
+    LzssOptions huffmanOptions = LzssOptions::CompressionLevel(LZSS_DEFAULT_LEVEL);
+    huffmanOptions.format = LzssFormat::Huffman;
+    const LzssResult lzssEncodedData11 = lzss_encode(inputData, 32768, 64, huffmanOptions);
+    const auto decodedBytes11 = lzss_decode_huffman(lzssEncodedData11.encodedBytes);
+    const bool eq11 = std::equal(inputData.begin(), inputData.end(), decodedBytes11.begin(), decodedBytes11.end());
+    report_lzss_result(inputFile, lzssEncodedData11, eq11);
+
     puts("-------------------------------");
 }
 
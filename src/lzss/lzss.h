@@ -1,6 +1,8 @@
 #pragma once
 
 #include "lz_tree.h"
+#include "hash_chain_match_finder.h"
+#include "binary_tree_match_finder.h"
 #include "lzss_token.h"
 #include "../sliding_window.h"
 #include <random>
@@ -10,9 +12,61 @@
 #include <azgra/fs/file_system.h>
 #include <array>
 
-constexpr std::size_t FLAG_GROUP_SIZE = 8;
 constexpr azgra::byte BYTE_SIZE = sizeof(azgra::byte);
 
+/**
+ * Number of positions parsed together by the optimal parser, matches don't cross the block end.
+ */
+constexpr std::size_t LZSS_OPTIMAL_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * Largest number of positions checked by the lazy evaluation after the found match.
+ */
+constexpr std::size_t LZSS_MAX_LAZY_STEPS = 2;
+
+/**
+ * Range of the compression levels and the default level.
+ */
+constexpr int LZSS_MIN_LEVEL = 1;
+constexpr int LZSS_MAX_LEVEL = 9;
+constexpr int LZSS_DEFAULT_LEVEL = 6;
+
+/**
+ * Size of the byte aligned format header: file size, SBits, LBits, literal count and pair count.
+ */
+constexpr std::size_t LZSS_BYTE_ALIGNED_HEADER_SIZE = 8 + 1 + 1 + 8 + 8;
+
+/**
+ * Default number of input bytes of the block encoded by lzss_encode_blocks.
+ */
+constexpr std::size_t LZSS_DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+/**
+ * Number of bytes copied at once by the byte aligned decoder.
+ */
+constexpr std::size_t LZSS_WIDE_COPY_SIZE = 16;
+
+/**
+ * Number of tokens buffered by the token writers before they are serialized.
+ */
+constexpr std::size_t LZSS_TOKEN_BLOCK_SIZE = 32 * 1024;
+static_assert((LZSS_TOKEN_BLOCK_SIZE % FLAG_GROUP_SIZE) == 0, "Token blocks end on the flag group boundary.");
+
+/**
+ * Number of tokens of the Huffman coded block, every block has its own codes.
+ */
+constexpr std::size_t LZSS_HUFFMAN_BLOCK_TOKEN_COUNT = 32 * 1024;
+
+/**
+ * Number of literal symbols of the Huffman literal/length alphabet, length slots follow them.
+ */
+constexpr std::size_t LZSS_HUFFMAN_LITERAL_COUNT = 256;
+
+/**
+ * Shortest match length of the Huffman coded format, lengths are coded relative to it.
+ */
+constexpr std::size_t LZSS_HUFFMAN_MIN_MATCH = 2;
+
 constexpr bool RAW_BYTE_FLAG = false;
 constexpr bool PAIR_FLAG = true;
 
@@ -97,16 +151,155 @@ struct LzssResult
 };
 
 
+/**
+ * Match finder used by the LZSS encoder.
+ */
+enum class LzssMatchFinder
+{
+    /**
+     * Binary search tree of the window positions.
+     */
+    BinaryTree,
+    /**
+     * Hash head table with the prev chain over the window.
+     */
+    HashChain,
+    /**
+     * Hashed binary trees over the cyclic window array, searched and updated in one walk.
+     */
+    HashBinaryTree
+};
+
+/**
+ * Parsing of the input into tokens.
+ */
+enum class LzssParsing
+{
+    /**
+     * The longest match is taken at every position.
+     */
+    Greedy,
+    /**
+     * Shortest path over all match candidates of the block, priced by the encoded token sizes.
+     * Uses the hash binary tree match finder.
+     */
+    Optimal
+};
+
+/**
+ * Layout of the encoded tokens.
+ */
+enum class LzssFormat
+{
+    /**
+     * Groups of 8 tokens with the flag byte, pairs are packed to SBits and LBits bits. Decoded by lzss_decode.
+     */
+    BitPacked,
+    /**
+     * Flags, literals, lengths and distances in separate byte aligned sections, lengths and distances
+     * take 1, 2 or 4 bytes. Decoded by lzss_decode_byte_aligned.
+     */
+    ByteAligned,
+    /**
+     * Literals and length slots share one Huffman code, distance slots have the second code and the slot
+     * extra bits follow the codes. Codes are rebuilt for every block of tokens. Decoded by lzss_decode_huffman.
+     */
+    Huffman
+};
+
+/**
+ * Options of the LZSS encoder.
+ */
+struct LzssOptions
+{
+    /**
+     * Match finder used by the encoder.
+     */
+    LzssMatchFinder matchFinder{LzssMatchFinder::BinaryTree};
+
+    /**
+     * Largest number of candidates checked by the hash chain or the hash binary tree match finder.
+     */
+    std::size_t maxChainLength{LZ_DEFAULT_CHAIN_LENGTH};
+
+    /**
+     * Parsing of the input into tokens.
+     */
+    LzssParsing parsing{LzssParsing::Greedy};
+
+    /**
+     * Number of following positions checked for the longer match before the greedy match is taken,
+     * at most LZSS_MAX_LAZY_STEPS. Used by the greedy parse with the hash match finders.
+     */
+    std::size_t lazyMatchSteps{0};
+
+    /**
+     * Length of the match, which is good enough to stop the search and the lazy evaluation.
+     */
+    std::size_t goodMatchLength{std::numeric_limits<std::size_t>::max()};
+
+    /**
+     * Layout of the encoded tokens.
+     */
+    LzssFormat format{LzssFormat::BitPacked};
+
+    LzssOptions() = default;
+
+    explicit LzssOptions(const LzssMatchFinder matchFinder_,
+                         const std::size_t maxChainLength_ = LZ_DEFAULT_CHAIN_LENGTH,
+                         const LzssParsing parsing_ = LzssParsing::Greedy)
+            : matchFinder(matchFinder_), maxChainLength(maxChainLength_), parsing(parsing_)
+    {
+    }
+
+    /**
+     * Create options of the numbered compression level. Lower levels search less candidates and prefer speed,
+     * middle levels add the lazy evaluation and the highest levels use the binary tree with the optimal parsing.
+     * @param level Compression level from LZSS_MIN_LEVEL to LZSS_MAX_LEVEL.
+     * @return Options of the level.
+     */
+    [[nodiscard]] static LzssOptions CompressionLevel(const int level);
+
+    /**
+     * Check whether the encoder searches the data directly, so it can use the history before the encoded data.
+     * @return True for the optimal parsing and the hash match finders.
+     */
+    [[nodiscard]] bool supports_history() const
+    {
+        return (parsing == LzssParsing::Optimal) || (matchFinder != LzssMatchFinder::BinaryTree);
+    }
+};
+
 /**
  * Compress data with LZSS algorithm.
  * @param data Data to compress.
  * @param searchBufferSize Size of the search buffer.
  * @param lookAheadBufferSize Size of the look ahead buffer.
+ * @param options Encoder options, selecting the match finder and the parsing.
  * @return Result of compression.
  */
 [[nodiscard]] LzssResult lzss_encode(const azgra::ByteArray &data,
                                      const std::size_t searchBufferSize,
-                                     const std::size_t lookAheadBufferSize);
+                                     const std::size_t lookAheadBufferSize,
+                                     const LzssOptions &options = LzssOptions());
+
+/**
+ * Compress the data after the history. Matches of the encoded data may reach into the history,
+ * so the decoder has to have the history decoded before the output.
+ * @param data History followed by the encoded data.
+ * @param dataSize Number of bytes of the history and the encoded data.
+ * @param historySize Number of history bytes, which are only searched for matches.
+ * @param searchBufferSize Size of the search buffer.
+ * @param lookAheadBufferSize Size of the look ahead buffer.
+ * @param options Encoder options, which have to support the history if there is any.
+ * @return Result of compression.
+ */
+[[nodiscard]] LzssResult lzss_encode_with_history(const azgra::byte *data,
+                                                  const std::size_t dataSize,
+                                                  const std::size_t historySize,
+                                                  const std::size_t searchBufferSize,
+                                                  const std::size_t lookAheadBufferSize,
+                                                  const LzssOptions &options);
 
 /**
  * Decode data compressed with the LZSS algorithm.
@@ -115,6 +308,84 @@ struct LzssResult
  */
 azgra::ByteArray lzss_decode(const azgra::ByteArray &encodedBytes);
 
+/**
+ * Get the decoded size of the data in the byte aligned format.
+ * @param encodedBytes Compressed bytes.
+ * @param encodedSize Number of compressed bytes.
+ * @return Size of the decompressed data.
+ */
+[[nodiscard]] std::size_t lzss_byte_aligned_decoded_size(const azgra::byte *encodedBytes, const std::size_t encodedSize);
+
+/**
+ * Decode data compressed in the byte aligned format into the caller buffer.
+ * @param encodedBytes Compressed bytes.
+ * @param encodedSize Number of compressed bytes.
+ * @param output Output buffer.
+ * @param outputCapacity Size of the output buffer, at least lzss_byte_aligned_decoded_size.
+ * @return Number of decompressed bytes.
+ */
+std::size_t lzss_decode_byte_aligned(const azgra::byte *encodedBytes,
+                                     const std::size_t encodedSize,
+                                     azgra::byte *output,
+                                     const std::size_t outputCapacity);
+
+/**
+ * Decode data compressed in the byte aligned format.
+ * @param encodedBytes Compressed bytes.
+ * @return Decompressed bytes.
+ */
+azgra::ByteArray lzss_decode_byte_aligned(const azgra::ByteArray &encodedBytes);
+
+/**
+ * Decode data compressed in the Huffman coded format.
+ * @param encodedBytes Compressed bytes.
+ * @return Decompressed bytes.
+ */
+azgra::ByteArray lzss_decode_huffman(const azgra::ByteArray &encodedBytes);
+
+/**
+ * Decode data compressed by lzss_encode_with_history into the output after the decoded history.
+ * @param format Layout of the encoded tokens.
+ * @param encodedBytes Compressed bytes.
+ * @param encodedSize Number of compressed bytes.
+ * @param output Output buffer, preceded by the decoded history.
+ * @param decodedSize Number of decompressed bytes.
+ * @param historySize Number of decoded bytes before the output.
+ */
+void lzss_decode_with_history(const LzssFormat format,
+                              const azgra::byte *encodedBytes,
+                              const std::size_t encodedSize,
+                              azgra::byte *output,
+                              const std::size_t decodedSize,
+                              const std::size_t historySize);
+
+/**
+ * Compress data in independent blocks, which are encoded in parallel. Encoded data start with the frame index
+ * of the block sizes, so that the blocks can be decoded in parallel too.
+ * @param data Data to compress.
+ * @param searchBufferSize Size of the search buffer.
+ * @param lookAheadBufferSize Size of the look ahead buffer.
+ * @param options Encoder options, used for every block.
+ * @param blockSize Number of input bytes of the block.
+ * @param primeBlocks True if blocks can reference the search buffer of the previous block input. Improves ratio
+ *                    of small blocks, but primed blocks are decoded in order. Needs the optimal parsing or the hash
+ *                    match finder.
+ * @return Result of compression.
+ */
+[[nodiscard]] LzssResult lzss_encode_blocks(const azgra::ByteArray &data,
+                                            const std::size_t searchBufferSize,
+                                            const std::size_t lookAheadBufferSize,
+                                            const LzssOptions &options = LzssOptions(),
+                                            const std::size_t blockSize = LZSS_DEFAULT_BLOCK_SIZE,
+                                            const bool primeBlocks = false);
+
+/**
+ * Decode data compressed by lzss_encode_blocks.
+ * @param encodedBytes Compressed bytes.
+ * @return Decompressed bytes.
+ */
+azgra::ByteArray lzss_decode_blocks(const azgra::ByteArray &encodedBytes);
+
 /**
  * Test LZSS compression, report results.
  * @param inputFile Input file.
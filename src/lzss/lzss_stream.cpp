@@ -0,0 +1,184 @@
+#include "lzss_stream.h"
+#include "../word_bit_stream.h"
+
+LzssStreamEncoder::LzssStreamEncoder(const std::size_t searchBufferSize,
+                                     const std::size_t lookAheadBufferSize,
+                                     const LzssOptions &options,
+                                     const std::size_t blockSize)
+        : m_searchBufferSize(searchBufferSize), m_lookAheadBufferSize(lookAheadBufferSize),
+          m_options(options), m_blockSize(blockSize)
+{
+    always_assert(blockSize > 0);
+    m_window.reserve(searchBufferSize + blockSize);
+
+    OutWordBitStream headerStream;
+    headerStream.write_value(static_cast<uint64_t>(searchBufferSize));
+    headerStream.write_value(static_cast<uint64_t>(blockSize));
+    headerStream.write_value(static_cast<azgra::byte>(options.format));
+    m_encoded = headerStream.get_flushed_buffer();
+}
+
+void LzssStreamEncoder::encode_block()
+{
+    const std::size_t blockLength = m_window.size() - m_historySize;
+    if (blockLength == 0)
+        return;
+
+    const LzssResult blockResult = lzss_encode_with_history(m_window.data(), m_window.size(), m_historySize,
+                                                            m_searchBufferSize, m_lookAheadBufferSize, m_options);
+    OutWordBitStream blockHeaderStream;
+    blockHeaderStream.write_value(static_cast<uint64_t>(blockLength));
+    blockHeaderStream.write_value(static_cast<uint64_t>(blockResult.encodedBytes.size()));
+    const azgra::ByteArray blockHeader = blockHeaderStream.get_flushed_buffer();
+    m_encoded.insert(m_encoded.end(), blockHeader.begin(), blockHeader.end());
+    m_encoded.insert(m_encoded.end(), blockResult.encodedBytes.begin(), blockResult.encodedBytes.end());
+
+    // NOTE(Moravec): Only the search buffer of the input is kept for the next block.
+    m_historySize = m_options.supports_history() ? std::min(m_searchBufferSize, m_window.size()) : 0;
+    m_window.erase(m_window.begin(), m_window.end() - m_historySize);
+}
+
+void LzssStreamEncoder::encode(const azgra::byte *chunk, const std::size_t chunkSize)
+{
+    std::size_t offset = 0;
+    while (offset < chunkSize)
+    {
+        const std::size_t blockLength = m_window.size() - m_historySize;
+        const std::size_t copySize = std::min(chunkSize - offset, m_blockSize - blockLength);
+        m_window.insert(m_window.end(), chunk + offset, chunk + offset + copySize);
+        offset += copySize;
+
+        if ((blockLength + copySize) == m_blockSize)
+        {
+            encode_block();
+        }
+    }
+}
+
+azgra::ByteArray LzssStreamEncoder::take_encoded_bytes()
+{
+    azgra::ByteArray encodedBytes;
+    encodedBytes.swap(m_encoded);
+    return encodedBytes;
+}
+
+azgra::ByteArray LzssStreamEncoder::finish()
+{
+    encode_block();
+    OutWordBitStream endStream;
+    endStream.write_value(static_cast<uint64_t>(0));
+    const azgra::ByteArray streamEnd = endStream.get_flushed_buffer();
+    m_encoded.insert(m_encoded.end(), streamEnd.begin(), streamEnd.end());
+    return take_encoded_bytes();
+}
+
+azgra::ByteArray LzssStreamDecoder::decode_available()
+{
+    azgra::ByteArray decoded;
+    if (!m_headerRead)
+    {
+        if (m_input.size() < LZSS_STREAM_HEADER_SIZE)
+            return decoded;
+
+        InWordBitStream headerStream(m_input.data(), m_input.size());
+        m_searchBufferSize = static_cast<std::size_t>(headerStream.read_value<uint64_t>());
+        m_blockSize = static_cast<std::size_t>(headerStream.read_value<uint64_t>());
+        m_format = static_cast<LzssFormat>(headerStream.read_value<azgra::byte>());
+        m_input.erase(m_input.begin(), m_input.begin() + LZSS_STREAM_HEADER_SIZE);
+        m_window.reserve(m_searchBufferSize + m_blockSize);
+        m_headerRead = true;
+    }
+
+    std::size_t inputOffset = 0;
+    while (!m_finished && ((m_input.size() - inputOffset) >= sizeof(uint64_t)))
+    {
+        InWordBitStream blockHeaderStream(m_input.data() + inputOffset, m_input.size() - inputOffset);
+        const auto blockLength = static_cast<std::size_t>(blockHeaderStream.read_value<uint64_t>());
+        if (blockLength == 0)
+        {
+            inputOffset += sizeof(uint64_t);
+            m_finished = true;
+            break;
+        }
+        if ((m_input.size() - inputOffset) < LZSS_STREAM_BLOCK_HEADER_SIZE)
+            break;
+        const auto encodedSize = static_cast<std::size_t>(blockHeaderStream.read_value<uint64_t>());
+        if ((m_input.size() - inputOffset - LZSS_STREAM_BLOCK_HEADER_SIZE) < encodedSize)
+            break;
+        always_assert(blockLength <= m_blockSize && "Corrupted LZSS stream.");
+
+        const std::size_t historySize = m_window.size();
+        m_window.resize(historySize + blockLength);
+        lzss_decode_with_history(m_format,
+                                 m_input.data() + inputOffset + LZSS_STREAM_BLOCK_HEADER_SIZE,
+                                 encodedSize,
+                                 m_window.data() + historySize,
+                                 blockLength,
+                                 historySize);
+        inputOffset += LZSS_STREAM_BLOCK_HEADER_SIZE + encodedSize;
+
+        decoded.insert(decoded.end(), m_window.begin() + historySize, m_window.end());
+        m_window.erase(m_window.begin(), m_window.end() - std::min(m_searchBufferSize, m_window.size()));
+    }
+    m_input.erase(m_input.begin(), m_input.begin() + inputOffset);
+    return decoded;
+}
+
+azgra::ByteArray LzssStreamDecoder::decode(const azgra::ByteArray &chunk)
+{
+    if (m_finished)
+        return azgra::ByteArray();
+
+    m_input.insert(m_input.end(), chunk.begin(), chunk.end());
+    return decode_available();
+}
+
+bool LzssStreamDecoder::finished() const
+{
+    return m_finished;
+}
+
+static void write_bytes(std::ostream &output, const azgra::ByteArray &bytes)
+{
+    output.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void lzss_encode_stream(std::istream &input,
+                        std::ostream &output,
+                        const std::size_t searchBufferSize,
+                        const std::size_t lookAheadBufferSize,
+                        const LzssOptions &options,
+                        const std::size_t blockSize)
+{
+    LzssStreamEncoder encoder(searchBufferSize, lookAheadBufferSize, options, blockSize);
+    azgra::ByteArray chunk(LZSS_STREAM_CHUNK_SIZE);
+    while (input)
+    {
+        input.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        const auto readCount = static_cast<std::size_t>(input.gcount());
+        if (readCount == 0)
+            break;
+
+        encoder.encode(chunk.data(), readCount);
+        write_bytes(output, encoder.take_encoded_bytes());
+    }
+    write_bytes(output, encoder.finish());
+}
+
+void lzss_decode_stream(std::istream &input, std::ostream &output, const std::size_t chunkSize)
+{
+    LzssStreamDecoder decoder;
+    azgra::ByteArray chunk(chunkSize);
+    while (input && !decoder.finished())
+    {
+        input.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunkSize));
+        const auto readCount = static_cast<std::size_t>(input.gcount());
+        if (readCount == 0)
+            break;
+
+        chunk.resize(readCount);
+        write_bytes(output, decoder.decode(chunk));
+        chunk.resize(chunkSize);
+    }
+    always_assert(decoder.finished() && "LZSS stream is truncated.");
+}
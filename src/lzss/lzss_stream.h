@@ -0,0 +1,188 @@
+#pragma once
+
+#include "lzss.h"
+#include <istream>
+#include <ostream>
+
+/**
+ * Default number of input bytes of the stream block. Stream memory is the search buffer plus one block.
+ */
+constexpr std::size_t LZSS_DEFAULT_STREAM_BLOCK_SIZE = 256 * 1024;
+
+/**
+ * Number of bytes read from the input stream at once.
+ */
+constexpr std::size_t LZSS_STREAM_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Size of the stream header: search buffer size, block size and format.
+ */
+constexpr std::size_t LZSS_STREAM_HEADER_SIZE = 8 + 8 + 1;
+
+/**
+ * Size of the block header: decoded block size and encoded block size. Zero decoded size ends the stream.
+ */
+constexpr std::size_t LZSS_STREAM_BLOCK_HEADER_SIZE = 8 + 8;
+
+/**
+ * LZSS encoder of the input given in chunks. Input is encoded in blocks, every block searches the last search buffer
+ * bytes of the previous input, so only the search buffer and the current block are held in memory.
+ */
+class LzssStreamEncoder
+{
+private:
+    /**
+     * Size of the search buffer.
+     */
+    std::size_t m_searchBufferSize{0};
+
+    /**
+     * Size of the look ahead buffer.
+     */
+    std::size_t m_lookAheadBufferSize{0};
+
+    /**
+     * Encoder options of every block.
+     */
+    LzssOptions m_options;
+
+    /**
+     * Number of input bytes of the block.
+     */
+    std::size_t m_blockSize{0};
+
+    /**
+     * History of the previous input followed by the input of the current block.
+     */
+    azgra::ByteArray m_window;
+
+    /**
+     * Number of history bytes at the window begin.
+     */
+    std::size_t m_historySize{0};
+
+    /**
+     * Encoded bytes, which weren't taken yet.
+     */
+    azgra::ByteArray m_encoded;
+
+    /**
+     * Encode the block input of the window and keep its tail as the history of the next block.
+     */
+    void encode_block();
+
+public:
+    /**
+     * Create the stream encoder and write the stream header.
+     * @param searchBufferSize Size of the search buffer.
+     * @param lookAheadBufferSize Size of the look ahead buffer.
+     * @param options Encoder options of every block, the history is used only if they support it.
+     * @param blockSize Number of input bytes of the block.
+     */
+    explicit LzssStreamEncoder(const std::size_t searchBufferSize,
+                               const std::size_t lookAheadBufferSize,
+                               const LzssOptions &options = LzssOptions::CompressionLevel(LZSS_DEFAULT_LEVEL),
+                               const std::size_t blockSize = LZSS_DEFAULT_STREAM_BLOCK_SIZE);
+
+    /**
+     * Encode the next chunk of the input. Blocks are encoded once they are full.
+     * @param chunk Chunk bytes.
+     * @param chunkSize Number of chunk bytes.
+     */
+    void encode(const azgra::byte *chunk, const std::size_t chunkSize);
+
+    /**
+     * Take the encoded bytes of the finished blocks.
+     * @return Encoded bytes since the last call.
+     */
+    [[nodiscard]] azgra::ByteArray take_encoded_bytes();
+
+    /**
+     * Encode the last block and write the stream end.
+     * @return Remaining encoded bytes.
+     */
+    [[nodiscard]] azgra::ByteArray finish();
+};
+
+/**
+ * Decoder of the LZSS stream given in chunks. Only the search buffer of the decoded data and the current block
+ * are held in memory.
+ */
+class LzssStreamDecoder
+{
+private:
+    /**
+     * Size of the search buffer.
+     */
+    std::size_t m_searchBufferSize{0};
+
+    /**
+     * Largest number of decoded bytes of the block.
+     */
+    std::size_t m_blockSize{0};
+
+    /**
+     * Layout of the encoded tokens.
+     */
+    LzssFormat m_format{LzssFormat::BitPacked};
+
+    /**
+     * Encoded bytes, which weren't decoded yet.
+     */
+    azgra::ByteArray m_input;
+
+    /**
+     * History of the decoded data followed by the decoded block.
+     */
+    azgra::ByteArray m_window;
+
+    bool m_headerRead{false};
+
+    bool m_finished{false};
+
+    /**
+     * Decode all complete blocks of the input.
+     * @return Decoded bytes.
+     */
+    azgra::ByteArray decode_available();
+
+public:
+    LzssStreamDecoder() = default;
+
+    /**
+     * Decode the next chunk of the stream.
+     * @param chunk Chunk of the encoded bytes.
+     * @return Bytes of the blocks completed by the chunk.
+     */
+    azgra::ByteArray decode(const azgra::ByteArray &chunk);
+
+    /**
+     * Check if the stream end was decoded.
+     * @return True after the stream end.
+     */
+    [[nodiscard]] bool finished() const;
+};
+
+/**
+ * Compress the input stream with LZSS, the output is written after every encoded block.
+ * @param input Input stream.
+ * @param output Output stream.
+ * @param searchBufferSize Size of the search buffer.
+ * @param lookAheadBufferSize Size of the look ahead buffer.
+ * @param options Encoder options of every block.
+ * @param blockSize Number of input bytes of the block.
+ */
+void lzss_encode_stream(std::istream &input,
+                        std::ostream &output,
+                        const std::size_t searchBufferSize,
+                        const std::size_t lookAheadBufferSize,
+                        const LzssOptions &options = LzssOptions::CompressionLevel(LZSS_DEFAULT_LEVEL),
+                        const std::size_t blockSize = LZSS_DEFAULT_STREAM_BLOCK_SIZE);
+
+/**
+ * Decode the stream compressed by lzss_encode_stream.
+ * @param input Input stream.
+ * @param output Output stream.
+ * @param chunkSize Number of bytes read from the input at once.
+ */
+void lzss_decode_stream(std::istream &input, std::ostream &output, const std::size_t chunkSize = LZSS_STREAM_CHUNK_SIZE);
@@ -1,41 +1,147 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
 #include "lz_match.h"
 
-class LzssToken
+/**
+ * Number of tokens sharing single flag byte.
+ */
+constexpr std::size_t FLAG_GROUP_SIZE = 8;
+
+/**
+ * Tokens of the block stored in the separate arrays. Every token has its flag bit, raw bytes are stored
+ * in the literal array and pairs in the length and distance arrays, so the raw byte takes a little over one byte
+ * and the pair a little over eight bytes. Parser fills the whole block and the writer serializes it afterwards.
+ */
+class LzssTokenBuffer
 {
 private:
     /**
-     * Only token created by one of the two static method is valid.
+     * Flags of the tokens, bit i of the byte is set if the token (byteIndex * FLAG_GROUP_SIZE + i) is the pair.
+     */
+    azgra::ByteArray m_flags;
+
+    /**
+     * Bytes of the raw byte tokens.
      */
-    bool m_valid{false};
+    azgra::ByteArray m_literals;
 
     /**
-     * True if is pair of distance and length.
+     * Lengths of the pair tokens.
      */
-    bool m_isPair{false};
+    std::vector<uint32_t> m_lengths;
 
     /**
-     * Raw byte data.
+     * Distances of the pair tokens.
      */
-    azgra::byte m_byte{0};
+    std::vector<uint32_t> m_distances;
 
     /**
-     * Pair match.
+     * Number of tokens in the buffer.
      */
-    LzMatch m_match;
+    std::size_t m_tokenCount{0};
+
+    inline void push_flag(const bool isPair)
+    {
+        const std::size_t flagIndex = m_tokenCount % FLAG_GROUP_SIZE;
+        if (flagIndex == 0)
+        {
+            m_flags.push_back(0);
+        }
+        m_flags.back() |= static_cast<azgra::byte>(isPair) << flagIndex;
+        ++m_tokenCount;
+    }
+
 public:
-    LzssToken() = default;
+    LzssTokenBuffer() = default;
+
+    /**
+     * Create the buffer with the reserved memory.
+     * @param tokenCapacity Expected number of tokens of the block.
+     */
+    explicit LzssTokenBuffer(const std::size_t tokenCapacity)
+    {
+        m_flags.reserve((tokenCapacity + FLAG_GROUP_SIZE - 1) / FLAG_GROUP_SIZE);
+        m_literals.reserve(tokenCapacity);
+        m_lengths.reserve(tokenCapacity);
+        m_distances.reserve(tokenCapacity);
+    }
+
+    /**
+     * Append the raw byte token.
+     * @param byte Raw byte.
+     */
+    inline void push_raw_byte(const azgra::byte byte)
+    {
+        push_flag(false);
+        m_literals.push_back(byte);
+    }
+
+    /**
+     * Append the pair token.
+     * @param match Distance and length of the pair.
+     */
+    inline void push_pair(const LzMatch &match)
+    {
+        push_flag(true);
+        m_lengths.push_back(static_cast<uint32_t>(match.length));
+        m_distances.push_back(static_cast<uint32_t>(match.distance));
+    }
 
-    [[nodiscard]] static LzssToken RawByteToken(const azgra::byte byte);
+    /**
+     * Remove all tokens, reserved memory is kept.
+     */
+    void clear()
+    {
+        m_flags.clear();
+        m_literals.clear();
+        m_lengths.clear();
+        m_distances.clear();
+        m_tokenCount = 0;
+    }
 
-    [[nodiscard]] static LzssToken PairToken(const LzMatch &match);
+    [[nodiscard]] std::size_t token_count() const
+    {
+        return m_tokenCount;
+    }
+
+    [[nodiscard]] std::size_t literal_count() const
+    {
+        return m_literals.size();
+    }
+
+    [[nodiscard]] std::size_t pair_count() const
+    {
+        return m_lengths.size();
+    }
+
+    /**
+     * Get length of the longest pair.
+     * @return The longest length, zero without pairs.
+     */
+    [[nodiscard]] std::size_t longest_match() const
+    {
+        return m_lengths.empty() ? 0 : *std::max_element(m_lengths.begin(), m_lengths.end());
+    }
 
-    [[nodiscard]] bool is_valid() const;
+    [[nodiscard]] const azgra::ByteArray &flags() const
+    {
+        return m_flags;
+    }
 
-    [[nodiscard]] bool is_pair() const;
+    [[nodiscard]] const azgra::ByteArray &literals() const
+    {
+        return m_literals;
+    }
 
-    [[nodiscard]] azgra::byte get_byte() const;
+    [[nodiscard]] const std::vector<uint32_t> &lengths() const
+    {
+        return m_lengths;
+    }
 
-    [[nodiscard]] LzMatch get_match() const;
-};
\ No newline at end of file
+    [[nodiscard]] const std::vector<uint32_t> &distances() const
+    {
+        return m_distances;
+    }
+};
@@ -4,6 +4,8 @@
 #include <azgra/io/binary_file_functions.h>
 #include "lzw.h"
 #include "entropy.h"
+#include "file_entropy.h"
+#include <numeric>
 #include <azgra/matrix.h>
 #include <sstream>
 
@@ -79,10 +81,10 @@ int main(int argc, char **argv)
         return 1;
     }
     const auto inputFile = argv[1];
-    const auto input = azgra::io::read_text_file(inputFile);
-    azgra::ByteArray inputData(input.begin(), input.end());
-    const auto symbolCount = inputData.size();
-    const auto entropy = calculate_entropy(inputData);
+    // File is read in chunks by multiple threads, it is never loaded as a whole.
+    const auto histogram = get_file_histogram(inputFile);
+    const auto symbolCount = std::accumulate(histogram.begin(), histogram.end(), static_cast<std::size_t>(0));
+    const auto entropy = calculate_entropy_from_histogram(histogram);
 
     fprintf(stdout, "Entropy of %s: %.4f; Symbol Count: %lu\n", inputFile, entropy, symbolCount);
 //    const std::vector<const char *> files = {
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <azgra/azgra.h>
+#include <type_traits>
+#include <algorithm>
+
+/**
+ * MSB-first bit writer used by the table driven entropy coders.
+ * Bits are accumulated in 64 bit register and stored as whole words.
+ */
+class OutWordBitStream
+{
+private:
+    /**
+     * Output bytes, always at least 8 bytes larger than the written part.
+     */
+    azgra::ByteArray m_buffer{};
+
+    /**
+     * Number of complete bytes in the output buffer.
+     */
+    std::size_t m_byteIndex{0};
+
+    /**
+     * Pending bits, aligned to the least significant bit.
+     */
+    uint64_t m_bitBuffer{0};
+
+    /**
+     * Number of pending bits in the bit buffer.
+     */
+    azgra::byte m_bitCount{0};
+
+    static inline void store_big_endian(azgra::byte *ptr, const uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            ptr[i] = static_cast<azgra::byte>(value >> (56 - (8 * i)));
+        }
+    }
+
+    /**
+     * Store the pending bits as whole word, keep the incomplete byte in the bit buffer.
+     */
+    inline void flush_word()
+    {
+        if (m_byteIndex + 8 > m_buffer.size())
+        {
+            m_buffer.resize(std::max<std::size_t>(2 * m_buffer.size(), m_byteIndex + 64));
+        }
+        store_big_endian(m_buffer.data() + m_byteIndex, m_bitBuffer << (64 - m_bitCount));
+        m_byteIndex += m_bitCount >> 3;
+        m_bitCount &= 7;
+    }
+
+public:
+    OutWordBitStream() = default;
+
+    /**
+     * Create the stream with pre-sized output buffer.
+     * @param expectedByteCount Expected number of written bytes.
+     */
+    explicit OutWordBitStream(const std::size_t expectedByteCount)
+    {
+        m_buffer.resize(expectedByteCount + 8);
+    }
+
+    /**
+     * Write the lowest bitCount bits of value, most significant bit first.
+     * @param value Value to write, must fit into bitCount bits.
+     * @param bitCount Number of bits to write, at most 32.
+     */
+    inline void write_bits(const uint64_t value, const azgra::byte bitCount)
+    {
+        m_bitBuffer = (m_bitBuffer << bitCount) | value;
+        m_bitCount += bitCount;
+        if (m_bitCount >= 32)
+        {
+            flush_word();
+        }
+    }
+
+    /**
+     * Write the whole value.
+     * @tparam T Integral type of the value.
+     * @param value Value to write.
+     */
+    template<typename T>
+    void write_value(const T value)
+    {
+        static_assert(std::is_integral_v<T>);
+        const auto bits = static_cast<uint64_t>(value);
+        for (long shift = static_cast<long>(sizeof(T) * 8) - 8; shift >= 0; shift -= 8)
+        {
+            write_bits((bits >> shift) & 0xFFu, 8);
+        }
+    }
+
+    /**
+     * Take the complete bytes written so far, incomplete byte stays in the stream.
+     * @return Complete written bytes.
+     */
+    azgra::ByteArray take_complete_bytes()
+    {
+        if (m_bitCount >= 8)
+        {
+            flush_word();
+        }
+        azgra::ByteArray bytes(m_buffer.begin(), m_buffer.begin() + m_byteIndex);
+        m_byteIndex = 0;
+        return bytes;
+    }
+
+    /**
+     * Pad the last byte with zeros and return the written bytes.
+     * @return Written bytes.
+     */
+    azgra::ByteArray get_flushed_buffer()
+    {
+        if (m_bitCount > 0)
+        {
+            write_bits(0, static_cast<azgra::byte>((8 - (m_bitCount & 7)) & 7));
+        }
+        if (m_bitCount > 0)
+        {
+            flush_word();
+        }
+        m_buffer.resize(m_byteIndex);
+        return std::move(m_buffer);
+    }
+};
+
+/**
+ * MSB-first bit reader with 64 bit look-ahead buffer.
+ * After refill() at least 56 bits can be peeked. Reading past the end yields zero bits.
+ */
+class InWordBitStream
+{
+private:
+    /**
+     * Encoded bytes.
+     */
+    const azgra::byte *m_data{nullptr};
+
+    /**
+     * Number of encoded bytes.
+     */
+    std::size_t m_size{0};
+
+    /**
+     * Index of the next byte to load.
+     */
+    std::size_t m_byteIndex{0};
+
+    /**
+     * Bit buffer, aligned to the most significant bit.
+     */
+    uint64_t m_bitBuffer{0};
+
+    /**
+     * Number of valid bits in the bit buffer.
+     */
+    azgra::byte m_bitCount{0};
+
+    static inline uint64_t load_big_endian(const azgra::byte *ptr)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+        return value;
+    }
+
+public:
+    InWordBitStream() = default;
+
+    /**
+     * Create reader over the encoded bytes.
+     * @param data Pointer to the encoded bytes.
+     * @param size Number of encoded bytes.
+     */
+    explicit InWordBitStream(const azgra::byte *data, const std::size_t size) : m_data(data), m_size(size)
+    {
+        refill();
+    }
+
+    /**
+     * Fill the bit buffer to at least 56 valid bits.
+     */
+    inline void refill()
+    {
+        if (m_byteIndex + 8 <= m_size)
+        {
+            // Load whole word, only complete bytes are counted as consumed.
+            m_bitBuffer |= load_big_endian(m_data + m_byteIndex) >> m_bitCount;
+            m_byteIndex += (63 - m_bitCount) >> 3;
+            m_bitCount |= 56;
+            return;
+        }
+        while (m_bitCount <= 56)
+        {
+            const uint64_t nextByte = (m_byteIndex < m_size) ? m_data[m_byteIndex] : 0;
+            ++m_byteIndex;
+            m_bitBuffer |= nextByte << (56 - m_bitCount);
+            m_bitCount += 8;
+        }
+    }
+
+    /**
+     * Get the next bitCount bits without consuming them.
+     * @param bitCount Number of bits, in range 1..56.
+     * @return Bits aligned to the least significant bit.
+     */
+    [[nodiscard]] inline uint32_t peek_bits(const azgra::byte bitCount) const
+    {
+        return static_cast<uint32_t>(m_bitBuffer >> (64 - bitCount));
+    }
+
+    /**
+     * Consume bitCount bits.
+     * @param bitCount Number of bits to consume.
+     */
+    inline void consume_bits(const azgra::byte bitCount)
+    {
+        m_bitBuffer <<= bitCount;
+        m_bitCount -= bitCount;
+    }
+
+    /**
+     * Read bitCount bits.
+     * @param bitCount Number of bits, in range 1..32.
+     * @return Read bits.
+     */
+    inline uint32_t read_bits(const azgra::byte bitCount)
+    {
+        refill();
+        const uint32_t bits = peek_bits(bitCount);
+        consume_bits(bitCount);
+        return bits;
+    }
+
+    /**
+     * Get number of bits consumed by the reader.
+     * @return Number of consumed bits.
+     */
+    [[nodiscard]] std::size_t consumed_bits() const
+    {
+        return (m_byteIndex * 8) - m_bitCount;
+    }
+
+    /**
+     * Get number of bytes consumed by the reader, the incomplete byte counts as consumed.
+     * @return Number of consumed bytes.
+     */
+    [[nodiscard]] std::size_t consumed_bytes() const
+    {
+        return (consumed_bits() + 7) / 8;
+    }
+
+    /**
+     * Read the whole value written by OutWordBitStream::write_value.
+     * @tparam T Integral type of the value.
+     * @return Read value.
+     */
+    template<typename T>
+    T read_value()
+    {
+        static_assert(std::is_integral_v<T>);
+        uint64_t bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bits = (bits << 8) | read_bits(8);
+        }
+        return static_cast<T>(bits);
+    }
+};
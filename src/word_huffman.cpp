@@ -0,0 +1,207 @@
+#include "word_huffman.h"
+#include <azgra/collection/robin_hood.h>
+#include <cstring>
+#include <cctype>
+
+/**
+ * Tokens up to this length are copied by the decoder with single fixed size copy.
+ */
+constexpr std::size_t HUFFMAN_WORD_SHORT_TOKEN_LENGTH = 16;
+
+/**
+ * Check whether the byte is part of the word. Bytes above ASCII are treated as letters, so that UTF-8 words
+ * of czech, german or hungarian text aren't split.
+ * @param c Byte of the text.
+ * @return True if the byte belongs to the word.
+ */
+static inline bool is_word_char(const char c)
+{
+    const auto byte = static_cast<unsigned char>(c);
+    return (byte >= 0x80) || std::isalnum(byte);
+}
+
+/**
+ * Split text into tokens without losing any byte. Unlike split_to_words, separators are kept as tokens of their own,
+ * because the text has to be reconstructed exactly.
+ * @param text Text to split.
+ * @return Alternating runs of word characters and separators.
+ */
+static std::vector<azgra::StringView> get_word_tokens(const azgra::StringView text)
+{
+    std::vector<azgra::StringView> tokens;
+    std::size_t tokenBegin = 0;
+    while (tokenBegin < text.size())
+    {
+        const bool isWord = is_word_char(text[tokenBegin]);
+        std::size_t tokenEnd = tokenBegin + 1;
+        while ((tokenEnd < text.size()) &&
+               (tokenEnd - tokenBegin < HUFFMAN_WORD_MAX_TOKEN_LENGTH) &&
+               (is_word_char(text[tokenEnd]) == isWord))
+        {
+            ++tokenEnd;
+        }
+        tokens.emplace_back(text.data() + tokenBegin, tokenEnd - tokenBegin);
+        tokenBegin = tokenEnd;
+    }
+    return tokens;
+}
+
+/**
+ * Get number of bits needed to store index of the rare token.
+ * @param rareTokenCount Number of tokens, which didn't fit into the 16 bit alphabet.
+ * @return Number of bits of the rare token index.
+ */
+static azgra::byte get_rare_index_bits(const std::size_t rareTokenCount)
+{
+    azgra::byte bits = 1;
+    while ((static_cast<std::size_t>(1) << bits) < rareTokenCount)
+    {
+        ++bits;
+    }
+    return bits;
+}
+
+azgra::ByteArray huffman_encode_words(const azgra::StringView textToEncode)
+{
+    const auto tokens = get_word_tokens(textToEncode);
+
+    // Collect the vocabulary with the token counts, tokens are kept in the order of the first occurrence.
+    robin_hood::unordered_map<azgra::StringView, uint32_t> tokenIndices;
+    std::vector<azgra::StringView> vocabulary;
+    std::vector<std::size_t> tokenCounts;
+    std::vector<uint32_t> tokenIndexStream(tokens.size());
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        const auto[it, inserted] = tokenIndices.try_emplace(tokens[i], static_cast<uint32_t>(vocabulary.size()));
+        if (inserted)
+        {
+            vocabulary.push_back(tokens[i]);
+            tokenCounts.push_back(0);
+        }
+        ++tokenCounts[it->second];
+        tokenIndexStream[i] = it->second;
+    }
+
+    // NOTE(Moravec): Identifiers are assigned by the descending frequency, so that only the rarest tokens
+    //                have to be escaped when the vocabulary doesn't fit into the 16 bit alphabet.
+    std::vector<uint32_t> order(vocabulary.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&tokenCounts](const uint32_t a, const uint32_t b)
+    {
+        return tokenCounts[a] > tokenCounts[b];
+    });
+    std::vector<uint32_t> tokenIds(vocabulary.size());
+    std::string vocabularyLengths(vocabulary.size(), '\0');
+    std::string vocabularyBytes;
+    for (uint32_t id = 0; id < order.size(); ++id)
+    {
+        const azgra::StringView token = vocabulary[order[id]];
+        tokenIds[order[id]] = id;
+        vocabularyLengths[id] = static_cast<char>(token.size());
+        vocabularyBytes.append(token.data(), token.size());
+    }
+
+    const std::size_t rareTokenCount = (vocabulary.size() > HUFFMAN_WORD_ESCAPE_ID) ? (vocabulary.size() - HUFFMAN_WORD_ESCAPE_ID) : 0;
+    const azgra::byte rareIndexBits = get_rare_index_bits(rareTokenCount);
+    std::vector<uint16_t> idStream(tokens.size());
+    OutWordBitStream escapeStream;
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        const uint32_t id = tokenIds[tokenIndexStream[i]];
+        if (id < HUFFMAN_WORD_ESCAPE_ID)
+        {
+            idStream[i] = static_cast<uint16_t>(id);
+            continue;
+        }
+        idStream[i] = HUFFMAN_WORD_ESCAPE_ID;
+        escapeStream.write_bits(id - HUFFMAN_WORD_ESCAPE_ID, rareIndexBits);
+    }
+
+    const azgra::ByteArray encodedLengths = huffman_encode_canonical(vocabularyLengths);
+    const azgra::ByteArray encodedVocabulary = huffman_encode_canonical(vocabularyBytes);
+    const azgra::ByteArray encodedIds = huffman_encode_symbols(idStream);
+    const azgra::ByteArray encodedEscapes = escapeStream.get_flushed_buffer();
+
+    OutWordBitStream headerStream;
+    headerStream.write_value(static_cast<uint64_t>(textToEncode.size()));
+    headerStream.write_value(static_cast<uint32_t>(vocabulary.size()));
+    headerStream.write_value(static_cast<uint64_t>(encodedLengths.size()));
+    headerStream.write_value(static_cast<uint64_t>(encodedVocabulary.size()));
+    headerStream.write_value(static_cast<uint64_t>(encodedIds.size()));
+
+    azgra::ByteArray encodedBytes = headerStream.get_flushed_buffer();
+    for (const auto *section : {&encodedLengths, &encodedVocabulary, &encodedIds, &encodedEscapes})
+    {
+        encodedBytes.insert(encodedBytes.end(), section->begin(), section->end());
+    }
+    return encodedBytes;
+}
+
+std::string huffman_decode_words(const azgra::ByteArray &encodedBytes)
+{
+    InWordBitStream headerStream(encodedBytes.data(), encodedBytes.size());
+    const auto expectedTextSize = headerStream.read_value<uint64_t>();
+    const auto vocabularySize = headerStream.read_value<uint32_t>();
+    const auto lengthsSize = headerStream.read_value<uint64_t>();
+    const auto vocabularyBytesSize = headerStream.read_value<uint64_t>();
+    const auto idsSize = headerStream.read_value<uint64_t>();
+
+    std::size_t sectionOffset = headerStream.consumed_bytes();
+    always_assert(sectionOffset + lengthsSize + vocabularyBytesSize + idsSize <= encodedBytes.size() &&
+                  "Corrupted word stream header.");
+    const auto get_section = [&encodedBytes, &sectionOffset](const std::size_t sectionSize)
+    {
+        const auto begin = encodedBytes.begin() + static_cast<long>(sectionOffset);
+        sectionOffset += sectionSize;
+        return azgra::ByteArray(begin, begin + static_cast<long>(sectionSize));
+    };
+
+    const std::string vocabularyLengths = huffman_decode_canonical(get_section(lengthsSize));
+    const std::string vocabularyBytes = huffman_decode_canonical(get_section(vocabularyBytesSize));
+    const std::vector<uint16_t> idStream = huffman_decode_symbols<uint16_t>(get_section(idsSize));
+    always_assert(vocabularyLengths.size() == vocabularySize);
+
+    std::vector<std::size_t> tokenOffsets(vocabularySize + 1, 0);
+    for (std::size_t id = 0; id < vocabularySize; ++id)
+    {
+        tokenOffsets[id + 1] = tokenOffsets[id] + static_cast<unsigned char>(vocabularyLengths[id]);
+    }
+    always_assert(tokenOffsets[vocabularySize] == vocabularyBytes.size());
+
+    const std::size_t rareTokenCount = (vocabularySize > HUFFMAN_WORD_ESCAPE_ID) ? (vocabularySize - HUFFMAN_WORD_ESCAPE_ID) : 0;
+    const azgra::byte rareIndexBits = get_rare_index_bits(rareTokenCount);
+    InWordBitStream escapeStream(encodedBytes.data() + sectionOffset, encodedBytes.size() - sectionOffset);
+
+    // NOTE(Moravec): Both buffers are padded, so that short tokens can be copied with single fixed size copy.
+    std::string vocabularyBuffer(vocabularyBytes);
+    vocabularyBuffer.resize(vocabularyBytes.size() + HUFFMAN_WORD_SHORT_TOKEN_LENGTH);
+    std::string decodedText(expectedTextSize + HUFFMAN_WORD_SHORT_TOKEN_LENGTH, '\0');
+    std::size_t textIndex = 0;
+    for (const uint16_t id : idStream)
+    {
+        std::size_t tokenId = id;
+        if (id == HUFFMAN_WORD_ESCAPE_ID)
+        {
+            tokenId += escapeStream.read_bits(rareIndexBits);
+        }
+        always_assert(tokenId < vocabularySize && "Corrupted word identifier.");
+        const std::size_t tokenLength = tokenOffsets[tokenId + 1] - tokenOffsets[tokenId];
+        always_assert(textIndex + tokenLength <= expectedTextSize);
+        const char *token = vocabularyBuffer.data() + tokenOffsets[tokenId];
+        if (tokenLength <= HUFFMAN_WORD_SHORT_TOKEN_LENGTH)
+        {
+            std::memcpy(decodedText.data() + textIndex, token, HUFFMAN_WORD_SHORT_TOKEN_LENGTH);
+        }
+        else
+        {
+            std::memcpy(decodedText.data() + textIndex, token, tokenLength);
+        }
+        textIndex += tokenLength;
+    }
+    always_assert(textIndex == expectedTextSize);
+    decodedText.resize(expectedTextSize);
+    return decodedText;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "large_alphabet_huffman.h"
+#include "huffman.h"
+
+/**
+ * Longest token of the word coder, longer runs are split so that token lengths fit into single byte.
+ */
+constexpr std::size_t HUFFMAN_WORD_MAX_TOKEN_LENGTH = 255;
+
+/**
+ * Token identifier used for the rare tokens, which didn't fit into the 16 bit alphabet.
+ * Index of the rare token follows in the escape stream.
+ */
+constexpr uint16_t HUFFMAN_WORD_ESCAPE_ID = 0xFFFFu;
+
+/**
+ * Encode text as the stream of word identifiers. Text is split into runs of word characters and runs of separators,
+ * every distinct token gets identifier ordered by its frequency. Vocabulary is stored once and identifiers are coded
+ * with the large alphabet Huffman coder.
+ * @param textToEncode Text to encode.
+ * @return Encoded bytes.
+ */
+azgra::ByteArray huffman_encode_words(const azgra::StringView textToEncode);
+
+/**
+ * Decode text encoded by huffman_encode_words.
+ * @param encodedBytes Encoded bytes.
+ * @return Decoded text.
+ */
+std::string huffman_decode_words(const azgra::ByteArray &encodedBytes);